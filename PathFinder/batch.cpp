@@ -0,0 +1,101 @@
+/*
+ * File: batch.cpp
+ * ---------------
+ * Implementation of the batch queries declared in batch.h.
+ */
+
+#include "batch.h"
+#include "graphreader.h"
+#include "parallel.h"
+#include "strutils.h"
+#include <pthread.h>
+
+
+void ReadQueries(string filename, Graph & graph, Vector<queryT> & queries)
+{
+	GraphReader in;
+	if (!in.open(filename)) Error("Cannot open the query file " + filename);
+	string source, target;
+	while (in.readWord(source)) {
+		if (!in.readWord(target)) {
+			Error("Query on line " + IntegerToString(in.lineNumber()) + " is missing its second city.");
+		}
+		queryT query;
+		query.source = graph.findNode(source);
+		query.target = graph.findNode(target);
+		if (query.source == NoSuchNode || query.target == NoSuchNode) {
+			Error("Query on line " + IntegerToString(in.lineNumber()) + " names a city that is not in the graph.");
+		}
+		queries.add(query);
+	}
+}
+
+
+/*
+ * Constant: QueryBlock
+ * --------------------
+ * The number of queries a thread takes from the shared counter at a
+ * time. Taking a few at once keeps the threads from queueing on the
+ * lock; taking only a few keeps them finishing at nearly the same time.
+ */
+static const int QueryBlock = 16;
+
+/* Implementation notes: RunQueries
+ * --------------------------------
+ * next is the first query no thread has taken yet, and the lock
+ * guards it. Each thread writes only to the results of the queries it
+ * took, so nothing else is shared that is written to. The graph works
+ * out its distance scale the first time A* asks for it, so it is
+ * asked for here, before the threads start, rather than by all of
+ * them at once.
+ */
+struct batchT {
+	Graph *graph;
+	searchAlgorithmT algorithm;
+	Vector<queryT> *queries;
+	searchResultT *results;
+	Landmarks *landmarks;
+	ContractionHierarchy *hierarchy;
+	bool keepPaths;
+	int next;
+	pthread_mutex_t lock;
+};
+
+static void AnswerQueries(int /* thread */, int /* numThreads */, batchT & batch)
+{
+	Vector<queryT> & queries = *batch.queries;
+	SearchWorkspace workspace;
+	while (true) {
+		pthread_mutex_lock(&batch.lock);
+		int start = batch.next;
+		batch.next += QueryBlock;
+		pthread_mutex_unlock(&batch.lock);
+		if (start >= queries.size()) break;
+		int end = (start + QueryBlock < queries.size()) ? start + QueryBlock : queries.size();
+		for (int i = start; i < end; i++) {
+			ShortestPath(*batch.graph, batch.algorithm, queries[i].source, queries[i].target, batch.results[i],
+						 batch.landmarks, batch.hierarchy, &workspace);
+			if (!batch.keepPaths) batch.results[i].nodes.clear();
+		}
+	}
+}
+
+int RunQueries(Graph & graph, searchAlgorithmT algorithm, Vector<queryT> & queries, searchResultT results[],
+				Landmarks *landmarks, ContractionHierarchy *hierarchy, bool keepPaths)
+{
+	batchT batch;
+	batch.graph = &graph;
+	batch.algorithm = algorithm;
+	batch.queries = &queries;
+	batch.results = results;
+	batch.landmarks = landmarks;
+	batch.hierarchy = hierarchy;
+	batch.keepPaths = keepPaths;
+	batch.next = 0;
+	pthread_mutex_init(&batch.lock, NULL);
+	if (algorithm == AStarSearch) graph.getDistanceScale();
+	int numThreads = ChooseThreadCount(queries.size(), QueryBlock);
+	RunInParallel(AnswerQueries, batch, numThreads);
+	pthread_mutex_destroy(&batch.lock);
+	return numThreads;
+}
@@ -0,0 +1,63 @@
+/*
+ * File: batch.h
+ * -------------
+ * Answers a whole list of shortest path queries at once, spread over
+ * several threads. The graph, landmarks and contraction hierarchy are
+ * only read by the searches, so the threads share them; everything a
+ * search writes to lives in a SearchWorkspace, and each thread keeps
+ * one of those for all of the queries it answers.
+ */
+
+#ifndef _batch_h
+#define _batch_h
+
+#include "genlib.h"
+#include "vector.h"
+#include "graph.h"
+#include "search.h"
+
+
+/*
+ * Type: queryT
+ * ------------
+ * One query: the ids of the city to start from and the city to reach.
+ */
+struct queryT {
+	int source;
+	int target;
+};
+
+
+/*
+ * Function: ReadQueries
+ * Usage: ReadQueries("trips.txt", graph, queries);
+ * ------------------------------------------------
+ * Reads a file with one query per line, the names of the two cities
+ * separated by white space, e.g.
+ *
+ *	SanFrancisco Boston
+ *
+ * and adds the queries to the vector in the order they are in the
+ * file. Raises an error if the file cannot be read or names a city
+ * that is not in the graph.
+ */
+void ReadQueries(string filename, Graph & graph, Vector<queryT> & queries);
+
+/*
+ * Function: RunQueries
+ * Usage: RunQueries(graph, DijkstraSearch, queries, results);
+ * -----------------------------------------------------------
+ * Answers every query with the given algorithm, as ShortestPath would,
+ * and stores the answer to queries[i] in results[i], which must have
+ * room for queries.size() results. The queries are shared out between
+ * GetThreadCount() threads, which take them a few at a time as they
+ * finish the last ones, so a thread that happens to get short queries
+ * does not sit idle. Unless keepPaths is true, the cities on each
+ * path are thrown away as soon as it is found, which saves memory
+ * when only the distances are wanted. Returns the number of threads
+ * that answered the queries.
+ */
+int RunQueries(Graph & graph, searchAlgorithmT algorithm, Vector<queryT> & queries, searchResultT results[],
+				Landmarks *landmarks = NULL, ContractionHierarchy *hierarchy = NULL, bool keepPaths = true);
+
+#endif
@@ -0,0 +1,388 @@
+/*
+ * File: benchmark.cpp
+ * -------------------
+ * Implementation of the micro-benchmarks declared in benchmark.h.
+ */
+
+#include "benchmark.h"
+#include "flatset.h"
+#include "graph.h"
+#include "random.h"
+#include "set.h"
+#include "stack.h"
+#include "timer.h"
+#include "vector.h"
+#include <iomanip>
+#include <iostream>
+
+
+/*
+ * Class: CopyingArray
+ * -------------------
+ * The stand-in for the old Vector: an array from new[], which
+ * default-constructs every slot up to the capacity, that doubles by
+ * copying each element into the new array and shifts elements by
+ * copying them one slot along.
+ */
+template <typename ElemType>
+class CopyingArray {
+  public:
+	CopyingArray(int sizeHint = 0) {
+		elements = new ElemType[sizeHint];
+		numAllocated = sizeHint;
+		numUsed = 0;
+	}
+	~CopyingArray() {
+		delete[] elements;
+	}
+	int size() {
+		return numUsed;
+	}
+	ElemType &operator[](int index) {
+		return elements[index];
+	}
+	void insertAt(int index, ElemType elem) {
+		if (numAllocated == numUsed) {
+			numAllocated = (numAllocated == 0 ? 10 : numAllocated*2);
+			ElemType *newArray = new ElemType[numAllocated];
+			for (int i = 0; i < numUsed; i++) newArray[i] = elements[i];
+			delete[] elements;
+			elements = newArray;
+		}
+		for (int i = numUsed; i > index; i--) elements[i] = elements[i-1];
+		elements[index] = elem;
+		numUsed++;
+	}
+	void add(ElemType elem) {
+		insertAt(numUsed, elem);
+	}
+	void removeAt(int index) {
+		for (int i = index; i < numUsed-1; i++) elements[i] = elements[i+1];
+		numUsed--;
+	}
+
+  private:
+	ElemType *elements;
+	int numAllocated, numUsed;
+};
+
+
+/*
+ * Type: benchPathT
+ * ----------------
+ * The same shape as pathT in pathfinder.cpp: what a search returns
+ * for one path.
+ */
+struct benchPathT {
+	double distance;
+	Stack<cityT> path;
+};
+
+/*
+ * Constants
+ * ---------
+ * The sizes of the benchmarks: about a second in all on a laptop.
+ */
+static const int NumArcs = 2000000;
+static const int NumPaths = 20000;
+static const int NumShiftedPaths = 2000;
+static const int CitiesPerPath = 50;
+
+static benchPathT MakeBenchPath(int index)
+{
+	benchPathT result;
+	result.distance = index;
+	for (int i = 0; i < CitiesPerPath; i++) {
+		cityT city;
+		city.location.x = city.location.y = i;
+		city.id = index + i;
+		result.path.push(city);
+	}
+	return result;
+}
+
+static arcT MakeArc(int index)
+{
+	arcT arc;
+	arc.city1 = index;
+	arc.city2 = index + 1;
+	arc.distance = index;
+	return arc;
+}
+
+/*
+ * Each fill function below is a template so that the same code runs
+ * on both containers; it returns a value that depends on the contents
+ * so that the compiler cannot leave the work out.
+ */
+template <typename ArrayType>
+static double AddArcs(ArrayType & arcs)
+{
+	for (int i = 0; i < NumArcs; i++) {
+		arcs.add(MakeArc(i));
+	}
+	return arcs[arcs.size() - 1].distance;
+}
+
+template <typename ArrayType>
+static double AddPaths(ArrayType & paths, benchPathT & path)
+{
+	for (int i = 0; i < NumPaths; i++) {
+		path.distance = i;
+		paths.add(path);
+	}
+	return paths[paths.size() - 1].distance;
+}
+
+template <typename ArrayType>
+static double ShiftPaths(ArrayType & paths, benchPathT & path)
+{
+	for (int i = 0; i < NumShiftedPaths; i++) {
+		path.distance = i;
+		paths.insertAt(0, path);
+	}
+	double sum = 0;
+	while (paths.size() > 0) {
+		sum += paths[0].distance;
+		paths.removeAt(0);
+	}
+	return sum;
+}
+
+static void PrintHeader(string title, string oldName, string newName)
+{
+	cout << setw(44) << left << title << right << setw(10) << oldName
+		<< setw(10) << newName << setw(10) << "speedup" << endl;
+}
+
+static void PrintRow(string label, double oldSeconds, double newSeconds)
+{
+	cout << setw(44) << left << label << right << fixed << setprecision(1)
+		<< setw(10) << oldSeconds * 1000 << setw(10) << newSeconds * 1000
+		<< setw(9) << setprecision(2) << oldSeconds / newSeconds << "x" << endl;
+}
+
+/*
+ * Implementation notes: VectorBenchmark
+ * -------------------------------------
+ * Every row times the same work on a CopyingArray and on a Vector.
+ * The last arc row fills the Vector the way the graph builder can,
+ * reserving room first and building each arc in place, against the
+ * CopyingArray given the same size up front.
+ */
+static void VectorBenchmark()
+{
+	double check = 0;
+	double start, oldTime, newTime;
+	PrintHeader("Vector benchmark", "old ms", "new ms");
+
+	start = CurrentTime();
+	{
+		CopyingArray<arcT> arcs;
+		check += AddArcs(arcs);
+	}
+	oldTime = CurrentTime() - start;
+	start = CurrentTime();
+	{
+		Vector<arcT> arcs;
+		check += AddArcs(arcs);
+	}
+	newTime = CurrentTime() - start;
+	PrintRow("add " + IntegerToString(NumArcs) + " arcT", oldTime, newTime);
+
+	start = CurrentTime();
+	{
+		CopyingArray<arcT> arcs(NumArcs);
+		check += AddArcs(arcs);
+	}
+	oldTime = CurrentTime() - start;
+	start = CurrentTime();
+	{
+		Vector<arcT> arcs;
+		arcs.reserve(NumArcs);
+		for (int i = 0; i < NumArcs; i++) {
+			arcT & arc = arcs.emplace();
+			arc.city1 = i;
+			arc.city2 = i + 1;
+			arc.distance = i;
+		}
+		check += arcs[NumArcs - 1].distance;
+	}
+	newTime = CurrentTime() - start;
+	PrintRow("presized, then reserve + emplace arcT", oldTime, newTime);
+
+	benchPathT path = MakeBenchPath(0);
+	start = CurrentTime();
+	{
+		CopyingArray<benchPathT> paths;
+		check += AddPaths(paths, path);
+	}
+	oldTime = CurrentTime() - start;
+	start = CurrentTime();
+	{
+		Vector<benchPathT> paths;
+		check += AddPaths(paths, path);
+	}
+	newTime = CurrentTime() - start;
+	PrintRow("add " + IntegerToString(NumPaths) + " paths of " + IntegerToString(CitiesPerPath) + " cities",
+			 oldTime, newTime);
+
+	start = CurrentTime();
+	{
+		CopyingArray<benchPathT> paths;
+		check += ShiftPaths(paths, path);
+	}
+	oldTime = CurrentTime() - start;
+	start = CurrentTime();
+	{
+		Vector<benchPathT> paths;
+		check += ShiftPaths(paths, path);
+	}
+	newTime = CurrentTime() - start;
+	PrintRow("insertAt(0)/removeAt(0) " + IntegerToString(NumShiftedPaths) + " paths", oldTime, newTime);
+
+	cout << "(checksum " << check << ")" << endl;
+}
+
+
+/*
+ * Constants
+ * ---------
+ * The sizes of the set benchmark: a graph of NumSetCities cities with
+ * NumSetArcs arcs, looked up NumLookups times.
+ */
+static const int NumSetCities = 200000;
+static const int NumSetArcs = 500000;
+static const int NumLookups = 1000000;
+
+static int CompareCityIds(cityT one, cityT two)
+{
+	return OperatorCmp(one.id, two.id);
+}
+
+static int CompareArcs(arcT one, arcT two)
+{
+	if (one.city1 != two.city1) return OperatorCmp(one.city1, two.city1);
+	return OperatorCmp(one.city2, two.city2);
+}
+
+/*
+ * The remaining templates run the same work on a Set and a FlatSet.
+ */
+template <typename SetType, typename ElemType>
+static double LookUp(SetType & set, Vector<ElemType> & keys)
+{
+	double found = 0;
+	for (int i = 0; i < NumLookups; i++) {
+		if (set.contains(keys[i % keys.size()])) found++;
+	}
+	return found;
+}
+
+template <typename SetType>
+static double IterateCities(SetType & set)
+{
+	double sum = 0;
+	typename SetType::Iterator itr = set.iterator();
+	while (itr.hasNext()) sum += itr.next().location.x;
+	return sum;
+}
+
+/*
+ * Implementation notes: SetBenchmark
+ * ----------------------------------
+ * The cities and arcs are in random order, as they would be in a file,
+ * and both kinds of set are built from the whole vector at once. Half
+ * of the keys looked up are in the set. The union merges the arcs
+ * into a set of the same size with half of them in common.
+ */
+static void SetBenchmark()
+{
+	double check = 0;
+	double start, setTime, flatTime;
+	PrintHeader("Set benchmark", "Set ms", "Flat ms");
+	Randomize();
+
+	Vector<cityT> cities, cityKeys;
+	for (int i = 0; i < NumSetCities; i++) {
+		cityT city;
+		city.id = RandomInteger(0, 2 * NumSetCities);
+		city.location.x = city.location.y = i;
+		cities.add(city);
+		city.id = RandomInteger(0, 2 * NumSetCities);
+		cityKeys.add(city);
+	}
+	Vector<arcT> arcs, moreArcs;
+	for (int i = 0; i < NumSetArcs; i++) {
+		arcT arc;
+		arc.city1 = RandomInteger(0, NumSetCities);
+		arc.city2 = RandomInteger(0, NumSetCities);
+		arc.distance = i;
+		arcs.add(arc);
+		if (i % 2 == 0) arc.city2 = RandomInteger(0, NumSetCities);
+		moreArcs.add(arc);
+	}
+
+	start = CurrentTime();
+	Set<cityT> citySet(cities, CompareCityIds);
+	setTime = CurrentTime() - start;
+	start = CurrentTime();
+	FlatSet<cityT> flatCities(cities, CompareCityIds);
+	flatTime = CurrentTime() - start;
+	PrintRow("build from " + IntegerToString(NumSetCities) + " cityT", setTime, flatTime);
+
+	start = CurrentTime();
+	check += LookUp(citySet, cityKeys);
+	setTime = CurrentTime() - start;
+	start = CurrentTime();
+	check += LookUp(flatCities, cityKeys);
+	flatTime = CurrentTime() - start;
+	PrintRow("contains " + IntegerToString(NumLookups) + " cityT", setTime, flatTime);
+
+	start = CurrentTime();
+	check += IterateCities(citySet);
+	setTime = CurrentTime() - start;
+	start = CurrentTime();
+	check += IterateCities(flatCities);
+	flatTime = CurrentTime() - start;
+	PrintRow("iterate over all cityT", setTime, flatTime);
+
+	start = CurrentTime();
+	Set<arcT> arcSet(arcs, CompareArcs), moreArcSet(moreArcs, CompareArcs);
+	setTime = CurrentTime() - start;
+	start = CurrentTime();
+	FlatSet<arcT> flatArcs(arcs, CompareArcs), moreFlatArcs(moreArcs, CompareArcs);
+	flatTime = CurrentTime() - start;
+	PrintRow("build 2 sets of " + IntegerToString(NumSetArcs) + " arcT", setTime, flatTime);
+
+	start = CurrentTime();
+	check += LookUp(arcSet, moreArcs);
+	setTime = CurrentTime() - start;
+	start = CurrentTime();
+	check += LookUp(flatArcs, moreArcs);
+	flatTime = CurrentTime() - start;
+	PrintRow("contains " + IntegerToString(NumLookups) + " arcT", setTime, flatTime);
+
+	start = CurrentTime();
+	arcSet.unionWith(moreArcSet);
+	setTime = CurrentTime() - start;
+	start = CurrentTime();
+	flatArcs.unionWith(moreFlatArcs);
+	flatTime = CurrentTime() - start;
+	PrintRow("unionWith of the two arcT sets", setTime, flatTime);
+
+	check += arcSet.size() + flatArcs.size();
+	cout << "(checksum " << check << ")" << endl;
+}
+
+
+void RunBenchmark(string name)
+{
+	if (name == "vector") {
+		VectorBenchmark();
+	} else if (name == "set") {
+		SetBenchmark();
+	} else {
+		Error("There is no benchmark called " + name + ".");
+	}
+}
@@ -0,0 +1,30 @@
+/*
+ * File: benchmark.h
+ * -----------------
+ * Micro-benchmarks of the containers the program is built on, run
+ * with --benchmark instead of opening the window. Each one times a
+ * container against an alternative to it (a simple stand-in for the
+ * way it used to work, or another container for the same job) on the
+ * kinds of elements the program actually stores, and prints the two
+ * times side by side.
+ */
+
+#ifndef _benchmark_h
+#define _benchmark_h
+
+#include "genlib.h"
+
+
+/*
+ * Function: RunBenchmark
+ * Usage: RunBenchmark("vector");
+ * ------------------------------
+ * Runs the named benchmark and prints its results to cout: "vector"
+ * fills, grows and shifts Vectors of arcT and of paths (a distance and
+ * a Stack<cityT>, like pathT), and "set" builds, searches, iterates
+ * over and merges Sets and FlatSets of cityT and arcT. Raises an error
+ * if there is no benchmark of that name.
+ */
+void RunBenchmark(string name);
+
+#endif
@@ -12,6 +12,8 @@
 
 #include "cmpfn.h"
 #include "vector.h"
+#include "nodepool.h"
+#include <algorithm>
 
 /*
  * Class: BST
@@ -23,6 +25,9 @@
  * The one requirement on the element type is that the client must
  * supply a comparison fn that compares two elements (or be willing 
  * to use the default comparison function that relies on < and ==).
+ * The nodes come from a NodePool owned by the tree, so a large tree
+ * takes a few big allocations rather than one per element, and
+ * clearing it gives them all back at once.
  */
 
 template <typename ElemType>
@@ -120,8 +125,28 @@ template <typename ElemType>
 		 * -------------------
 		 * This member function removes all elements from this tree. The 
 		 * tree is made empty and will have no nodes after being cleared.
+		 * The elements are destroyed one by one, but their nodes' storage
+		 * is freed a slab at a time.
 		 */	
 		void clear();
+
+
+		/*
+		 * Member function: build
+		 * Usage: bst.build(elems);
+		 * ------------------------
+		 * This member function replaces the contents of this tree with
+		 * the elements of the vector, which is not changed. If the
+		 * elements are already in increasing order, the tree is built
+		 * directly from them in time proportional to their number, with
+		 * no comparisons beyond checking the order; otherwise a copy is
+		 * sorted first. Where the vector holds several equal elements,
+		 * the tree keeps the last, as adding them one at a time would.
+		 * The new tree is perfectly balanced: no path from the root is
+		 * more than one node longer than any other.
+		 */
+		void build(Vector<ElemType> & elems);
+
 		
 		/*
 		 * Member function: mapAll
@@ -174,6 +199,7 @@ template <typename ElemType>
 
 		nodeT *root;
 		int numNodes;
+		NodePool<nodeT> pool;
 		int (*cmpFn)(ElemType, ElemType);
 		
 		static const int RightHeavy = +1;
@@ -186,6 +212,7 @@ template <typename ElemType>
 		bool removeTargetNode(nodeT * & t);
 		void updateBF(nodeT * &t, int bfDelta);
 		void recDeleteTree(nodeT * t);
+		void deleteNode(nodeT * t);
 		void recMapAll(nodeT * t, void (fn)(ElemType));
 		template <typename ClientDataType>
 		void recMapAll(nodeT * t, void (fn)(ElemType, ClientDataType &), ClientDataType &);
@@ -194,6 +221,18 @@ template <typename ElemType>
 		void rotateRight(nodeT * &t);
 		void rotateLeft(nodeT * &t);
 		void copyOtherEntries(const BST &other);
+		bool isStrictlyIncreasing(Vector<ElemType> & elems);
+		nodeT *recBuildTree(Vector<ElemType> & elems, int start, int count, int & height);
+
+		/*
+		 * The ordering std::stable_sort needs, in terms of cmpFn.
+		 */
+		struct lessThan {
+			int (*cmpFn)(ElemType, ElemType);
+			bool operator()(const ElemType & one, const ElemType & two) const {
+				return cmpFn(one, two) < 0;
+			}
+		};
 };
 
 
@@ -213,15 +252,30 @@ template <typename ElemType>
 	    recDeleteTree(root);
 	}
 
+/*
+ * Implementation notes: recDeleteTree, deleteNode
+ * -----------------------------------------------
+ * recDeleteTree destroys every node of the subtree but leaves their
+ * storage in the pool, which the caller then frees all at once, either
+ * with pool.clear() or by destroying the pool. deleteNode destroys a
+ * single node and gives its storage back to the pool for reuse.
+ */
 template <typename ElemType>
   void BST<ElemType>::recDeleteTree(nodeT * t)
 	{
 	    if (t != NULL) {
 			recDeleteTree(t->left);
 			recDeleteTree(t->right);
-			delete t;
+			t->~nodeT();
 	  	}	
 	}
+
+template <typename ElemType>
+  void BST<ElemType>::deleteNode(nodeT * t)
+	{
+		t->~nodeT();
+		pool.release(t);
+	}
 	
 template <typename ElemType>
   int BST<ElemType>::size()
@@ -240,6 +294,7 @@ template <typename ElemType>
   void BST<ElemType>::clear()
 	{
 	    recDeleteTree(root);
+		pool.clear();
 		root = NULL;
 		numNodes = 0;
 	}
@@ -310,7 +365,7 @@ template <typename ElemType>
   bool BST<ElemType>::recAddNode(nodeT * & t, ElemType & data, bool &createdNewNode)
 	{
 	    if (t == NULL) {
-	        t = new nodeT;
+	        t = new (pool.allocate()) nodeT;
 	        t->data = data;
 	        t->bf = Even;
 	        t->left = t->right = NULL;
@@ -461,6 +516,73 @@ template <typename ElemType>
 
 
 
+/*
+ * Implementation notes: build, recBuildTree
+ * -----------------------------------------
+ * Unsorted input is sorted stably, so that equal elements keep their
+ * order, and then only the last of each run of equal elements is kept.
+ * recBuildTree makes the middle element of its range the root and
+ * builds the two halves below it the same way. The left half gets
+ * the extra element when the count is even, so the left subtree is
+ * never shorter than the right one and the balance factor is the
+ * difference of their heights, LeftHeavy or Even. A node is allocated
+ * before its children, so the slab holds the tree in preorder and a
+ * search moves forward through memory.
+ */
+template <typename ElemType>
+  void BST<ElemType>::build(Vector<ElemType> & elems)
+	{
+		clear();
+		int height;
+		if (isStrictlyIncreasing(elems)) {
+			pool.reserve(elems.size());
+			root = recBuildTree(elems, 0, elems.size(), height);
+			numNodes = elems.size();
+			return;
+		}
+		Vector<ElemType> sorted(elems);
+		lessThan less;
+		less.cmpFn = cmpFn;
+		std::stable_sort(&sorted[0], &sorted[0] + sorted.size(), less);
+		Vector<ElemType> distinct(sorted.size());
+		for (int i = 0; i < sorted.size(); i++) {
+			if (i + 1 == sorted.size() || cmpFn(sorted[i], sorted[i + 1]) != 0)
+				distinct.add(sorted[i]);
+		}
+		pool.reserve(distinct.size());
+		root = recBuildTree(distinct, 0, distinct.size(), height);
+		numNodes = distinct.size();
+	}
+
+template <typename ElemType>
+  bool BST<ElemType>::isStrictlyIncreasing(Vector<ElemType> & elems)
+	{
+		for (int i = 1; i < elems.size(); i++) {
+			if (cmpFn(elems[i - 1], elems[i]) >= 0) return (false);
+		}
+		return (true);
+	}
+
+template <typename ElemType>
+  typename BST<ElemType>::nodeT * BST<ElemType>::recBuildTree(Vector<ElemType> & elems,
+														int start, int count, int & height)
+	{
+		if (count == 0) {
+			height = 0;
+			return (NULL);
+		}
+		int leftCount = count / 2;
+		int leftHeight, rightHeight;
+		nodeT * t = new (pool.allocate()) nodeT;
+		t->data = elems[start + leftCount];
+		t->left = recBuildTree(elems, start, leftCount, leftHeight);
+		t->right = recBuildTree(elems, start + leftCount + 1, count - leftCount - 1, rightHeight);
+		t->bf = rightHeight - leftHeight;
+		height = leftHeight + 1;
+		return (t);
+	}
+
+
  /*
  * Implementation notes: remove, recRemoveNode
  * -------------------------------------------
@@ -525,12 +647,12 @@ template <typename ElemType>
 
 	    if (t->left == NULL) {	// no left child, replace with right
 	        t = t->right;
-	        delete toDelete;
+	        deleteNode(toDelete);
 			numNodes--;
 	        return (true);
 	    } else if (t->right == NULL) {	// no right child, replace with left
 	        t = t->left;
-	        delete toDelete;
+	        deleteNode(toDelete);
 			numNodes--;
 	        return (true);
 	    } else {	// node has both children, replace with successor (max of left)
@@ -632,6 +754,7 @@ template <typename ElemType>
 		// erroneous complaints. Sigh.
 		BST &rhs = const_cast<BST &>(constRhs);
 		cmpFn = rhs.cmpFn;
+		pool.reserve(rhs.numNodes);
 		
 		// This is a workaround for a bug in Metrowerks C++ compiler.
 		// It can't handle the dual-templated map function correctly, so
@@ -0,0 +1,476 @@
+/*
+ * File: flatset.h
+ * ---------------
+ * This interface file contains the FlatSet class template, a set
+ * kept as a sorted array, for sets that are built once and then
+ * mostly searched and walked through.
+ */
+
+#ifndef _flatset_h_
+#define _flatset_h_
+
+#include "cmpfn.h"
+#include "vector.h"
+#include <algorithm>
+
+
+/*
+ * Class: FlatSet
+ * --------------
+ * This interface defines a class template with the same operations
+ * as Set, storing the elements in increasing order in one contiguous
+ * array rather than in the nodes of a balanced tree. Looking an
+ * element up is a binary search through that array and iterating is a
+ * scan along it, both of which touch far less memory than following
+ * tree pointers, and the set takes no space beyond the elements. The
+ * price is that add and remove shift every later element along, so
+ * adding n elements one at a time takes time proportional to n^2:
+ * build a FlatSet from a vector, or add to it with addAll, which sort
+ * the new elements once and merge them in.
+ */
+template <typename ElemType>
+  class FlatSet {
+
+	public:
+
+		/*
+		 * Constructor: FlatSet
+		 * Usage: FlatSet<int> set;
+		 *        FlatSet<student> students(CompareStudentsById);
+		 *        FlatSet<cityT> cities(cityList, CompareCities);
+		 * -------------------------------------------------------
+		 * The constructors initialize a set that is empty or holds the
+		 * elements of the vector. The comparison function is optional and
+		 * works as for Set. Building from a vector sorts it once (or not
+		 * at all if it is in order already).
+		 */
+		FlatSet(int (cmpFn)(ElemType, ElemType) = OperatorCmp);
+		explicit FlatSet(Vector<ElemType> & elems, int (cmpFn)(ElemType, ElemType) = OperatorCmp);
+
+		/*
+		 * Member functions: size, isEmpty
+		 * Usage: count = set.size();
+		 *        if (set.isEmpty())...
+		 * ----------------------------
+		 * These member functions return the number of elements in this
+		 * set and whether it is empty.
+		 */
+		int size();
+		bool isEmpty();
+
+		/*
+		 * Member functions: add, addAll, remove
+		 * Usage: set.add(value);
+		 *        set.addAll(values);
+		 *        set.remove(value);
+		 * ------------------------------
+		 * These member functions behave as they do for Set: add overwrites
+		 * an equal element already in the set, and addAll is the same as
+		 * adding each element of the vector in turn. add and remove take
+		 * time proportional to the size of the set; addAll takes time
+		 * proportional to the size of the set plus that of sorting the
+		 * vector.
+		 */
+		void add(ElemType elem);
+		void addAll(Vector<ElemType> & elems);
+		void remove(ElemType elem);
+
+		/*
+		 * Member functions: contains, find
+		 * Usage: if (set.contains(value))...
+		 *        eptr = set.find(elem);
+		 * -----------------------------------
+		 * contains returns true if the element is in this set. find
+		 * returns a pointer to the equal element in the set, or NULL if
+		 * there is none. The pointer is only good until the set is next
+		 * changed, and the element must not be changed in a way that
+		 * alters its position in the order.
+		 */
+		bool contains(ElemType elem);
+		ElemType *find(ElemType elem);
+
+		/*
+		 * Member functions: equals, isSubsetOf
+		 * Usage: if (set.equals(set2)) . . .
+		 *        if (set.isSubsetOf(set2)) . . .
+		 * --------------------------------------
+		 * These predicate functions implement set equality and the
+		 * subset relation as for Set, in one pass along both sets.
+		 */
+		bool equals(FlatSet & otherSet);
+		bool isSubsetOf(FlatSet & otherSet);
+
+		/*
+		 * Member functions: unionWith, intersect, subtract
+		 * Usage: set.unionWith(set2);
+		 *        set.intersect(set2);
+		 *        set.subtract(set2);
+		 * ---------------------------
+		 * These member functions modify this set as for Set, by merging
+		 * the two sorted arrays, in time proportional to the sizes of the
+		 * two sets together. Raise an error if the two sets do not use
+		 * the same comparison function.
+		 */
+		void unionWith(FlatSet & otherSet);
+		void intersect(FlatSet & otherSet);
+		void subtract(FlatSet & otherSet);
+
+		/*
+		 * Member function: clear
+		 * Usage: set.clear();
+		 * -------------------
+		 * This member function removes all elements from this set.
+		 */
+		void clear();
+
+		/*
+		 * Member functions: mapAll
+		 * Usage: set.mapAll(Print);
+		 *        set.mapAll(PrintToFile, outputStream);
+		 * --------------------------------------------
+		 * These member functions call fn once for each element, in
+		 * order, passing the client's data too in the second form.
+		 */
+		void mapAll(void (fn)(ElemType elem));
+		template <typename ClientDataType>
+			void mapAll(void (fn)(ElemType elem, ClientDataType &data),
+							ClientDataType &data);
+
+		/*
+		 * Class: FlatSet<ElemType>::Iterator
+		 * Usage: FlatSet<int>::Iterator itr = set.iterator();
+		 *        while (itr.hasNext()) int num = itr.next();
+		 * -------------------------------------------------
+		 * An iterator over the elements in order, used like the one for
+		 * Set. Unlike Set's, it reads the set's own array rather than a
+		 * copy, so making one is free, and the set must not be changed
+		 * while it is in use.
+		 */
+		class Iterator {
+			public:
+				Iterator();
+				bool hasNext();
+				ElemType next();
+
+			private:
+				Iterator(FlatSet *setptr);
+				FlatSet *sp;
+				int curIndex;
+				friend class FlatSet;
+		};
+		friend class Iterator;
+
+		Iterator iterator();
+
+		/*
+		 * Deep copying support
+		 * --------------------
+		 * As for Set, the copy constructor and operator= synthesized by
+		 * the compiler copy the whole set, which here is one array.
+		 */
+
+	private:
+		Vector<ElemType> elems;			// in strictly increasing order
+		int (*cmpFn)(ElemType, ElemType);
+
+		int lowerBound(ElemType & key);
+		void sortDistinct(Vector<ElemType> & sorted);
+
+		/*
+		 * The ordering std::stable_sort needs, in terms of cmpFn.
+		 */
+		struct lessThan {
+			int (*cmpFn)(ElemType, ElemType);
+			bool operator()(const ElemType & one, const ElemType & two) const {
+				return cmpFn(one, two) < 0;
+			}
+		};
+  };
+
+
+/*
+ * FlatSet class implementation
+ * ----------------------------
+ * The elements live in a Vector in strictly increasing order. Every
+ * lookup goes through lowerBound, and the set operations are merges
+ * of two sorted arrays, as in merge sort.
+ */
+
+template <typename ElemType>
+  FlatSet<ElemType>::FlatSet(int (cmp)(ElemType, ElemType))
+	{
+		cmpFn = cmp;
+	}
+
+template <typename ElemType>
+  FlatSet<ElemType>::FlatSet(Vector<ElemType> & elements, int (cmp)(ElemType, ElemType)) : elems(elements)
+	{
+		cmpFn = cmp;
+		sortDistinct(elems);
+	}
+
+template <typename ElemType>
+  int FlatSet<ElemType>::size()
+	{
+		return elems.size();
+	}
+
+template <typename ElemType>
+  bool FlatSet<ElemType>::isEmpty()
+	{
+		return elems.isEmpty();
+	}
+
+/*
+ * Private member function: lowerBound
+ * Usage: int index = lowerBound(key);
+ * -----------------------------------
+ * Returns the index of the first element that is not less than key,
+ * or size() if there is none. Each step halves the range that can
+ * hold the answer, keeping the lower half or the upper half depending
+ * on one comparison, so the loop runs the same number of times
+ * whatever the key and the choice compiles to a conditional move
+ * rather than a branch that is mispredicted half of the time. Without
+ * the branch the processor no longer guesses ahead, so the elements the
+ * next step might compare with, the middles of both halves, are
+ * prefetched while this step's comparison runs.
+ */
+template <typename ElemType>
+  int FlatSet<ElemType>::lowerBound(ElemType & key)
+	{
+		int n = elems.size();
+		if (n == 0) return 0;
+		ElemType *first = &elems[0];
+		ElemType *base = first;
+		while (n > 1) {
+			int half = n / 2;
+#ifdef __GNUC__
+			__builtin_prefetch(base + half / 2);
+			__builtin_prefetch(base + half + half / 2);
+#endif
+			base = (cmpFn(base[half], key) < 0) ? base + half : base;
+			n -= half;
+		}
+		return (base - first) + (cmpFn(*base, key) < 0);
+	}
+
+/*
+ * Private member function: sortDistinct
+ * Usage: sortDistinct(elements);
+ * ------------------------------
+ * Puts the vector in strictly increasing order. It is stably sorted
+ * unless it is in order already, and then only the last of each run
+ * of equal elements is kept, as adding them one at a time would.
+ */
+template <typename ElemType>
+  void FlatSet<ElemType>::sortDistinct(Vector<ElemType> & sorted)
+	{
+		bool inOrder = true;
+		for (int i = 1; i < sorted.size() && inOrder; i++)
+			inOrder = (cmpFn(sorted[i - 1], sorted[i]) < 0);
+		if (inOrder) return;
+		lessThan less;
+		less.cmpFn = cmpFn;
+		std::stable_sort(&sorted[0], &sorted[0] + sorted.size(), less);
+		int numKept = 0;
+		for (int i = 0; i < sorted.size(); i++) {
+			if (i + 1 == sorted.size() || cmpFn(sorted[i], sorted[i + 1]) != 0)
+				sorted[numKept++] = sorted[i];
+		}
+		while (sorted.size() > numKept)
+			sorted.removeAt(sorted.size() - 1);
+	}
+
+template <typename ElemType>
+  void FlatSet<ElemType>::add(ElemType elem)
+	{
+		int index = lowerBound(elem);
+		if (index < elems.size() && cmpFn(elems[index], elem) == 0) {
+			elems[index] = elem;
+		} else {
+			elems.insertAt(index, elem);
+		}
+	}
+
+template <typename ElemType>
+  void FlatSet<ElemType>::addAll(Vector<ElemType> & elements)
+	{
+		FlatSet other(elements, cmpFn);
+		unionWith(other);
+	}
+
+template <typename ElemType>
+  void FlatSet<ElemType>::remove(ElemType elem)
+	{
+		int index = lowerBound(elem);
+		if (index < elems.size() && cmpFn(elems[index], elem) == 0)
+			elems.removeAt(index);
+	}
+
+template <typename ElemType>
+  bool FlatSet<ElemType>::contains(ElemType elem)
+	{
+		return (find(elem) != NULL);
+	}
+
+template <typename ElemType>
+  ElemType *FlatSet<ElemType>::find(ElemType elem)
+	{
+		int index = lowerBound(elem);
+		if (index < elems.size() && cmpFn(elems[index], elem) == 0)
+			return &elems[index];
+		return NULL;
+	}
+
+template <typename ElemType>
+  void FlatSet<ElemType>::clear()
+	{
+		elems.clear();
+	}
+
+/*
+ * Implementation notes: Set operations
+ * ------------------------------------
+ * Each operation walks the two sorted arrays side by side. intersect
+ * and subtract only ever drop elements of this set, so they compact
+ * its array in place; unionWith builds the merged array separately
+ * and swaps it in. Where both sets hold an equal element, unionWith
+ * keeps the one from otherSet, as add would.
+ */
+
+template <typename ElemType>
+  bool FlatSet<ElemType>::equals(FlatSet & otherSet)
+	{
+		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to equals doesn't have same comparison function");
+		if (size() != otherSet.size()) return false;
+		for (int i = 0; i < size(); i++) {
+			if (cmpFn(elems[i], otherSet.elems[i]) != 0)
+				return false;
+		}
+		return true;
+	}
+
+template <typename ElemType>
+  bool FlatSet<ElemType>::isSubsetOf(FlatSet & otherSet)
+	{
+		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to isSubsetOf doesn't have same comparison function");
+		int j = 0;
+		for (int i = 0; i < size(); i++) {
+			while (j < otherSet.size() && cmpFn(otherSet.elems[j], elems[i]) < 0)
+				j++;
+			if (j == otherSet.size() || cmpFn(otherSet.elems[j], elems[i]) != 0)
+				return false;
+		}
+		return true;
+	}
+
+template <typename ElemType>
+  void FlatSet<ElemType>::unionWith(FlatSet & otherSet)
+	{
+		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to unionWith doesn't have same comparison function");
+		Vector<ElemType> & theirs = otherSet.elems;
+		Vector<ElemType> merged(elems.size() + theirs.size());
+		int i = 0, j = 0;
+		while (i < elems.size() && j < theirs.size()) {
+			int sign = cmpFn(elems[i], theirs[j]);
+			if (sign < 0) {
+				merged.add(elems[i++]);
+			} else {
+				if (sign == 0) i++;
+				merged.add(theirs[j++]);
+			}
+		}
+		while (i < elems.size()) merged.add(elems[i++]);
+		while (j < theirs.size()) merged.add(theirs[j++]);
+		elems.swap(merged);
+	}
+
+template <typename ElemType>
+  void FlatSet<ElemType>::intersect(FlatSet & otherSet)
+	{
+		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to intersect doesn't have same comparison function");
+		Vector<ElemType> & theirs = otherSet.elems;
+		int numKept = 0, j = 0;
+		for (int i = 0; i < elems.size(); i++) {
+			while (j < theirs.size() && cmpFn(theirs[j], elems[i]) < 0)
+				j++;
+			if (j < theirs.size() && cmpFn(theirs[j], elems[i]) == 0)
+				elems[numKept++] = elems[i];
+		}
+		while (elems.size() > numKept)
+			elems.removeAt(elems.size() - 1);
+	}
+
+template <typename ElemType>
+  void FlatSet<ElemType>::subtract(FlatSet & otherSet)
+	{
+		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to subtract doesn't have same comparison function");
+		Vector<ElemType> & theirs = otherSet.elems;
+		int numKept = 0, j = 0;
+		for (int i = 0; i < elems.size(); i++) {
+			while (j < theirs.size() && cmpFn(theirs[j], elems[i]) < 0)
+				j++;
+			if (j == theirs.size() || cmpFn(theirs[j], elems[i]) != 0)
+				elems[numKept++] = elems[i];
+		}
+		while (elems.size() > numKept)
+			elems.removeAt(elems.size() - 1);
+	}
+
+template <typename ElemType>
+  void FlatSet<ElemType>::mapAll(void (fn)(ElemType))
+	{
+		for (int i = 0; i < elems.size(); i++)
+			fn(elems[i]);
+	}
+
+template <typename ElemType>
+ template <typename ClientDataType>
+  void FlatSet<ElemType>::mapAll(void (fn)(ElemType, ClientDataType &), ClientDataType &data)
+	{
+		for (int i = 0; i < elems.size(); i++)
+			fn(elems[i], data);
+	}
+
+
+/*
+ * FlatSet::Iterator class implementation
+ * --------------------------------------
+ * The iterator holds the set and the index of the next element.
+ */
+
+template <typename ElemType>
+  FlatSet<ElemType>::Iterator::Iterator()
+	{
+		sp = NULL;
+	}
+
+template <typename ElemType>
+  FlatSet<ElemType>::Iterator::Iterator(FlatSet *setptr)
+	{
+		sp = setptr;
+		curIndex = 0;
+	}
+
+template <typename ElemType>
+  typename FlatSet<ElemType>::Iterator FlatSet<ElemType>::iterator()
+	{
+		return Iterator(this);
+	}
+
+template <typename ElemType>
+  bool FlatSet<ElemType>::Iterator::hasNext()
+	{
+		if (sp == NULL) Error("hasNext called on uninitialized iterator");
+		return curIndex < sp->size();
+	}
+
+template <typename ElemType>
+  ElemType FlatSet<ElemType>::Iterator::next()
+	{
+		if (sp == NULL) Error("next called on uninitialized iterator");
+		if (!hasNext()) Error("Attempt to get next from iterator where hasNext() is false");
+		return sp->elems[curIndex++];
+	}
+
+#endif // _flatset_h_
@@ -13,7 +13,9 @@
 #include "vector.h"
 #include <string>
 #include "genlib.h"
+#include <algorithm> // for swap
 #include <cstdlib> // for NULL
+#include <cstring> // for memcmp
 
 /*
  * Class: Map
@@ -24,6 +26,9 @@
  * The keys are always of type string, but the value type is set
  * by the client. The client specializes the map to hold values of a 
  * specific type, e.g. Map<int> or Map<studentT>, as needed.
+ * Lookups can also be given a key as a pointer to its first character
+ * and a length, so a name inside a larger buffer (a line being parsed,
+ * say) can be looked up without first being copied into a string.
  */
 
 template <typename ValueType> 
@@ -85,7 +90,7 @@ template <typename ValueType>
 		 * entry. If there was already an entry for this key, the map's
 		 * size is unchanged; otherwise, it increments by one.
 		 */
-		void add(string key, ValueType value);	
+		void add(const string &key, ValueType value);	
 		
 		
 		/*
@@ -97,7 +102,7 @@ template <typename ValueType>
 		 * Otherwise, the key and its associated value are removed and 
 		 * the map's size decreases by one.
 		 */
-		void remove(string key);
+		void remove(const string &key);
 		
 		
 		/*
@@ -105,9 +110,26 @@ template <typename ValueType>
 		 * Usage: if (map.containsKey(key))...
 		 * -----------------------------------
 		 * Returns true if there is an entry for key in this map, 
-		 * false otherwise.
+		 * false otherwise. The second form looks up the length
+		 * characters starting at start.
 		 */
-		bool containsKey(string key);
+		bool containsKey(const string &key);
+		bool containsKey(const char *start, int length);
+
+
+		/*
+		 * Member function: find
+		 * Usage: ValueType *vp = map.find(key);
+		 * -------------------------------------
+		 * If key is found in this map, this member function returns a
+		 * pointer to the associated value, which allows it to be read or
+		 * updated in place; otherwise it returns NULL. This does with one
+		 * lookup what containsKey followed by getValue does with two. The
+		 * pointer is only good until the next entry is added or removed.
+		 * The second form looks up the length characters starting at start.
+		 */
+		ValueType *find(const string &key);
+		ValueType *find(const char *start, int length);
 
 
 		/*
@@ -119,7 +141,7 @@ template <typename ValueType>
 		 * containsKey member function can be used to verify the presence 
 		 * of a key in the map before attempting to get its value.
 		 */
-		ValueType getValue(string key);
+		ValueType getValue(const string &key);
 
 
 		/*
@@ -139,7 +161,7 @@ template <typename ValueType>
 		 * function returns the value by reference, it allows in-place 
 		 * modification of the value.
 		 */			
-		ValueType &operator[](string key);
+		ValueType &operator[](const string &key);
 		
 		
 		/*
@@ -249,19 +271,35 @@ template <typename ValueType>
 		Map(const Map &rhs);
 		
 		private:	
-			struct cell {
+			/*
+			 * The table is two parallel arrays with a slot for every
+			 * power-of-two capacity: meta holds each entry's full hash and
+			 * its probe distance, entries the key and value themselves.
+			 * Probing reads only meta until a hash matches.
+			 */
+			struct metaT {
+				unsigned hash;
+				int distance;		// 1 + slots from the entry's home slot, 0 if empty
+			};
+			struct entryT {
 				string key;
 				ValueType value;
-				cell *next;
 			};
-			
-			Vector<cell *> buckets;	
+
+			metaT *meta;
+			entryT *entries;
+			int capacity;			// always a power of two
 			int numEntries;
-	
-			void initBuckets(int nBuckets);
-			void deleteBuckets(Vector<cell *> &bucketsToDelete);
-			int hash(string s);
-			cell *findCell(cell *head, string key, cell **prev = NULL);
+
+			static const int MinCapacity = 8;
+
+			void initTable(int minEntries);
+			void allocateTable(int newCapacity);
+			void deleteTable();
+			static unsigned hash(const char *start, int length);
+			int findSlot(const char *start, int length, unsigned hashCode);
+			int insertNew(const string &key, unsigned hashCode);
+			void placeEntry(metaT carryMeta, entryT &carry, int &resultSlot);
 			void expandAndRehash();
 			void copyOtherEntries(const Map &rhs);
 	};
@@ -280,12 +318,19 @@ template <typename ValueType>
 /*
  * Class: Map
  * -------------
- * In this mapimplementation, the entries are stored in a hashtable.
- * The hashtable keeps a vector of "buckets", where each bucket is a linked list
- * of elements that share the same hash code (i.e. hash collisions are resolved
- * by chaining). The buckets are dynamically allocated so that we can change the
- * the number of buckets (rehash) when the load factor becomes too high. The
- * map should provide O(1) performance on the add/remove/getValue operations.
+ * In this map implementation, the entries are stored in an open-addressing
+ * hashtable with Robin Hood probing. An entry goes in the slot its hash picks
+ * (its home slot) or, if that is taken, in one of the slots after it. While
+ * probing for a place, a new entry takes over the slot of any entry that is
+ * closer to its own home than the new one is, and that entry moves on in its
+ * place. This keeps every entry close to home, so a lookup can stop as soon
+ * as it meets an entry that is closer to home than the key would be. Each slot
+ * remembers the full hash of its key, so most mismatches are rejected without
+ * comparing characters and growing the table never hashes a key again. The
+ * keys and values live in the slots themselves rather than in separately
+ * allocated cells, and are moved to a bigger table with swap, not copied. The
+ * table is kept at most three-quarters full, and the map provides O(1)
+ * expected performance on the add/remove/getValue operations.
  */
 
 
@@ -293,13 +338,13 @@ template <typename ValueType>
   Map<ValueType>::Map(int sizeHint)
 	{
 	  if (sizeHint < 0) Error("Negative sizeHint given to Map constructor");
-		initBuckets(sizeHint);
+		initTable(sizeHint);
 	}
 
 template <typename ValueType>
   Map<ValueType>::~Map()
 	{
-		deleteBuckets(buckets);
+		deleteTable();
 	}
 
 template <typename ValueType>
@@ -315,74 +360,100 @@ template <typename ValueType>
 	}
 
 template <typename ValueType>
-  void Map<ValueType>::add(string key, ValueType value)
+  void Map<ValueType>::add(const string &key, ValueType value)
 	{
 		(*this)[key] = value;	// adds entry if not present
 	}
 
+/*
+ * Implementation notes: remove
+ * ----------------------------
+ * Rather than leaving a marker in the slot of the removed entry, the
+ * entries after it that are not in their home slots each move back by
+ * one, which is what a lookup for them expects after the removal.
+ * The removed key and value are swapped along to the last slot moved
+ * from, which is then emptied.
+ */
 template <typename ValueType>
-  void Map<ValueType>::remove(string key)
+  void Map<ValueType>::remove(const string &key)
 	{
-	   	int hashCode = hash(key);
-	   	cell *prev, *found = findCell(buckets[hashCode], key, &prev);
-		if (found != NULL) {
-			if (prev != NULL) 
-				prev->next = found->next;	 // splice out of list if in middle
-			else 
-				buckets[hashCode] = found->next;	// remove head node if first
-			numEntries--;
-			delete found;
+		int slot = findSlot(key.data(), key.length(), hash(key.data(), key.length()));
+		if (slot < 0) return;
+		int mask = capacity - 1;
+		int next = (slot + 1) & mask;
+		while (meta[next].distance > 1) {
+			entries[slot].key.swap(entries[next].key);
+			std::swap(entries[slot].value, entries[next].value);
+			meta[slot].hash = meta[next].hash;
+			meta[slot].distance = meta[next].distance - 1;
+			slot = next;
+			next = (next + 1) & mask;
 		}
+		meta[slot].distance = 0;
+		entries[slot].key = string();
+		entries[slot].value = ValueType();
+		numEntries--;
 	}
 
 template <typename ValueType>
   void Map<ValueType>::clear()
 	{
-	   	deleteBuckets(buckets);
-		numEntries = 0;
+	   	deleteTable();
+		initTable(0);
 	}
 
 
 template <typename ValueType>
-  bool Map<ValueType>::containsKey(string key)
+  bool Map<ValueType>::containsKey(const string &key)
+	{
+		return (find(key) != NULL);
+	}
+
+template <typename ValueType>
+  bool Map<ValueType>::containsKey(const char *start, int length)
 	{
-		int hashCode = hash(key);
-		return (findCell(buckets[hashCode], key) != NULL);
+		return (find(start, length) != NULL);
+	}
+
+template <typename ValueType>
+  ValueType *Map<ValueType>::find(const string &key)
+	{
+		return find(key.data(), key.length());
+	}
+
+template <typename ValueType>
+  ValueType *Map<ValueType>::find(const char *start, int length)
+	{
+		int slot = findSlot(start, length, hash(start, length));
+		return (slot < 0) ? NULL : &entries[slot].value;
 	}
 	
 
 template <typename ValueType>
-  ValueType Map<ValueType>::getValue(string key)
+  ValueType Map<ValueType>::getValue(const string &key)
 	{
-		if (containsKey(key))
-			return (*this)[key];
+		ValueType *vp = find(key);
+		if (vp != NULL)
+			return *vp;
 		Error("Attempt to getValue for key which is not contained in map.");
 		return ValueType();	// this code is never reached, but here to placate compiler
 	}
 
 
 template <typename ValueType> 
-  ValueType & Map<ValueType>::operator[](string key)
+  ValueType & Map<ValueType>::operator[](const string &key)
 	{
-		int hashCode = hash(key);
-		cell *cp = findCell(buckets[hashCode], key);
-		if (cp == NULL) {
-		    if (numEntries > buckets.size()*2) expandAndRehash();
-		    hashCode = hash(key); // num buckets has changed
-			cp = new cell;
-			cp->key = key;
-			cp->next = buckets[hashCode];
-			buckets[hashCode] = cp;
-			numEntries++;
-		}
-		return cp->value;
+		unsigned hashCode = hash(key.data(), key.length());
+		int slot = findSlot(key.data(), key.length(), hashCode);
+		if (slot < 0) slot = insertNew(key, hashCode);
+		return entries[slot].value;
 	}
 
 template <typename ValueType> 
   const Map<ValueType> &Map<ValueType>::operator=(const Map &rhs) 
 	{
 		if (this != &rhs) {
-			deleteBuckets(buckets);
+			deleteTable();
     		copyOtherEntries(rhs);
 		}
 		return *this;
@@ -399,18 +470,18 @@ template <typename ValueType>
   template <typename ClientData>
 	void Map<ValueType>::mapAll(void (*fn)(string key, ValueType value, ClientData &cd), ClientData &data)
 	{	
-		for (int i =0 ; i < buckets.size(); i++)
-			for (cell *cp = buckets[i]; cp != NULL; cp = cp->next)
-				fn(cp->key, cp->value, data);	
+		for (int i = 0; i < capacity; i++)
+			if (meta[i].distance != 0)
+				fn(entries[i].key, entries[i].value, data);	
 	}
 	
 	
 template <typename ValueType> 
   void Map<ValueType>::mapAll(void (*fn)(string key, ValueType value))
 	{	
-		for (int i =0 ; i < buckets.size(); i++)
-			for (cell *cp = buckets[i]; cp != NULL; cp = cp->next)
-				fn(cp->key, cp->value);	
+		for (int i = 0; i < capacity; i++)
+			if (meta[i].distance != 0)
+				fn(entries[i].key, entries[i].value);	
 	}
 	
 
@@ -419,134 +490,178 @@ template <typename ValueType>
 
 
 /*
- * Private member function: deleteBuckets
- * Usage: deleteBuckets(buckets);
- * ------------------------------
- * This function deletes all the cells in the linked lists contained in vector.
+ * Private member functions: initTable, allocateTable, deleteTable
+ * Usage: initTable(sizeHint);
+ * ---------------------------
+ * initTable sets up an empty table with room for at least minEntries
+ * entries, which is never less than MinCapacity slots. allocateTable
+ * allocates the arrays for newCapacity slots, all empty, without
+ * touching numEntries, and deleteTable frees them.
  */
+template <typename ValueType> 
+  void Map<ValueType>::initTable(int minEntries)
+	{
+		int newCapacity = MinCapacity;
+		while (3 * newCapacity < 4 * minEntries)
+			newCapacity *= 2;
+		allocateTable(newCapacity);
+        numEntries = 0;
+	}	
+
+template <typename ValueType> 
+  void Map<ValueType>::allocateTable(int newCapacity)
+	{
+		capacity = newCapacity;
+		meta = new metaT[capacity];
+		for (int i = 0; i < capacity; i++)
+			meta[i].distance = 0;
+		entries = new entryT[capacity];
+	}	
 
 template <typename ValueType>
-  void Map<ValueType>::deleteBuckets(Vector<cell *> &b)
+  void Map<ValueType>::deleteTable()
 	{
-		for (int i = 0; i < b.size(); i++) {
-		    while (b[i] != NULL) {
-		        cell *next = b[i]->next;
-		        delete b[i];
-		        b[i] = next;
-		    }
-	    }
+		delete[] meta;
+		delete[] entries;
 	}
 
+
 /*
- * Private member function: findCell
- * Usage: cp = findCell(cp, key, &prev);
- * -------------------------------------
- * This function finds a cell in the chain beginning at cp that
- * matches key.  If a match is found, a pointer to that cell is
- * returned.  If no match is found, the function returns NULL.
- * The optional third argument is a pointer to the previous cell
- * pointer, which the client may need if attempting to splice out
- * the found cell. If not specified, NULL is the default value.
+ * Private member function: hash
+ * Usage: hashCode = hash(start, length);
+ * --------------------------------------
+ * This function returns the 32-bit FNV-1a hash of the characters,
+ * which is quick on short keys and spreads them well enough that the
+ * low bits can pick the home slot.
  */
 template <typename ValueType>
-  typename Map<ValueType>::cell 
-         *Map<ValueType>::findCell(cell *cp, string key, cell **prevByRef)
+  unsigned Map<ValueType>::hash(const char *start, int length)
 	{
-		cell *prev = NULL;
-	    while (cp != NULL && key != cp->key) {
-	    	prev = cp;
-	        cp = cp->next;
-	    }
-	    if (prevByRef != NULL) *prevByRef = prev;
-	    return (cp);
+		unsigned hashCode = 2166136261u;
+		for (int i = 0; i < length; i++) {
+			hashCode ^= (unsigned char) start[i];
+			hashCode *= 16777619u;
+		}
+		return hashCode;
 	}
 
 
 /*
- * Private member function: hash
- * Usage: bucket = hash(key);
- * --------------------------
- * This function takes the key and uses it to derive a hash code,
- * which is an integer in the range [0, buckets.size() - 1].  The hash
- * code is computed using a method called linear congruence.
+ * Private member function: findSlot
+ * Usage: slot = findSlot(start, length, hashCode);
+ * ------------------------------------------------
+ * This function returns the slot holding the key, or -1 if it is not
+ * in the map. The probe stops at an empty slot or at an entry closer
+ * to its home than the key would be at that point, since Robin Hood
+ * insertion would have put the key there.
  */
 template <typename ValueType>
-  int Map<ValueType>::hash(string s)
+  int Map<ValueType>::findSlot(const char *start, int length, unsigned hashCode)
 	{
-		const long Multiplier = -1664117991;
-	    unsigned long hashcode = 0;
-	    for (string::size_type i = 0; i < s.length(); i++) {
-	        hashcode = hashcode * Multiplier + s[i];
-	    }
-	    return (hashcode % buckets.size());
+		int mask = capacity - 1;
+		int slot = hashCode & mask;
+		for (int distance = 1; ; distance++) {
+			if (meta[slot].distance < distance) return -1;
+			if (meta[slot].hash == hashCode && int(entries[slot].key.length()) == length
+				&& memcmp(entries[slot].key.data(), start, length) == 0) return slot;
+			slot = (slot + 1) & mask;
+		}
 	}
 
 
+/*
+ * Private member functions: insertNew, placeEntry
+ * Usage: slot = insertNew(key, hashCode);
+ * ---------------------------------------
+ * insertNew adds an entry for a key that is not in the map, with the
+ * default value, growing the table first if it would become more than
+ * three-quarters full, and returns its slot. placeEntry does the Robin
+ * Hood probing: carry is swapped into the first slot that is empty or
+ * holds an entry closer to home, the entry displaced from there (if
+ * any) is carried on in the same way, and so on until a slot is empty.
+ * resultSlot is set to where the first entry carried ended up unless
+ * it is already set. carry is left holding an empty key.
+ */
+template <typename ValueType>
+  int Map<ValueType>::insertNew(const string &key, unsigned hashCode)
+	{
+		if (4 * (numEntries + 1) > 3 * capacity) expandAndRehash();
+		metaT carryMeta;
+		carryMeta.hash = hashCode;
+		carryMeta.distance = 1;
+		entryT carry;
+		carry.key = key;
+		int resultSlot = -1;
+		placeEntry(carryMeta, carry, resultSlot);
+		numEntries++;
+		return resultSlot;
+	}
+
+template <typename ValueType>
+  void Map<ValueType>::placeEntry(metaT carryMeta, entryT &carry, int &resultSlot)
+	{
+		int mask = capacity - 1;
+		for (int slot = carryMeta.hash & mask; ; slot = (slot + 1) & mask) {
+			if (meta[slot].distance < carryMeta.distance) {
+				bool wasEmpty = (meta[slot].distance == 0);
+				std::swap(meta[slot], carryMeta);
+				entries[slot].key.swap(carry.key);
+				std::swap(entries[slot].value, carry.value);
+				if (resultSlot < 0) resultSlot = slot;
+				if (wasEmpty) return;
+			}
+			carryMeta.distance++;
+		}
+	}
+
 
 /*
  * Private member function: expandAndRehash
  * Usage: expandAndRehash();
  * -------------------------
- * This member function is used to increase the number of buckets in the map
- * and then rehashes all existing entries and adds them into new buckets.  This
- * operation is used when the load factor (i.e. the number of cells per bucket)
- * has increased enough to warrant this O(N) operation to enlarge and redistribute
- * the entries.
+ * This member function doubles the number of slots and moves every
+ * entry into the new table, using the hash stored with it rather than
+ * hashing the key again and swapping the key and value in rather than
+ * copying them, so no key is reallocated. This O(N) operation happens
+ * when the table would otherwise become more than three-quarters full.
  */
 template <typename ValueType>
   void Map<ValueType>::expandAndRehash()
 	{
-		Vector<cell *>oldBuckets = buckets;	// make copy of existing buckets
-		initBuckets(oldBuckets.size()*2 + 1); 	// make bigger array of empty buckets
-	    for (int i = 0; i < oldBuckets.size(); i++)
-	        for (cell *cp = oldBuckets[i]; cp != NULL; cp = cp->next)
-	            add(cp->key, cp->value);	// add all old cells into new buckets
-	    deleteBuckets(oldBuckets);			// delete previous cells
+		metaT *oldMeta = meta;
+		entryT *oldEntries = entries;
+		int oldCapacity = capacity;
+		allocateTable(2 * oldCapacity);
+		int unused = 0;
+		for (int i = 0; i < oldCapacity; i++) {
+			if (oldMeta[i].distance != 0) {
+				metaT carryMeta = oldMeta[i];
+				carryMeta.distance = 1;
+				placeEntry(carryMeta, oldEntries[i], unused);
+			}
+		}
+		delete[] oldMeta;
+		delete[] oldEntries;
 	}
 
-		
-/*
- * Private member function: initBuckets
- * Usage: initBuckets(101);
- * -----------------------
- * This member functions sets up the vector of buckets to have nBuckets
- * entries, each NULL. If asked to make empty vector, makes one bucket
- * just to simplify handling elsewhere.
- */
-template <typename ValueType> 
-  void Map<ValueType>::initBuckets(int nBuckets)
-	{
-	  if (nBuckets == 0) nBuckets = 1;
-		buckets = Vector<cell *>(nBuckets);
-    	for (int i = 0; i < nBuckets; i++) 
-    		buckets.add(NULL);
-        numEntries = 0;
-	}	
-	
-	
-template <typename ValueType>
-  static void AddToMap(string key, ValueType val, Map<ValueType> &map)
-	{
-		map.add(key, val);
-  	}
 	
 /*
  * Private member function: copyOtherEntries
  * Usage: copyOtherEntries(otherMap);
  * ----------------------------------
- * This member functions adds a copy of all entries from the other map to
- * this one.
+ * This member functions makes this map a copy of the other one. The
+ * table is copied slot for slot, so no entry needs to be placed again.
  */
 template <typename ValueType> 
-	void Map<ValueType>::copyOtherEntries(const Map &constRhs)
+	void Map<ValueType>::copyOtherEntries(const Map &rhs)
 	{
-		// We aren't really adhering to const. Even though the member functions
-		// invoked on rhs don't modify it, they aren't marked const, and thus
-		// trigger compiler problems. We cast away const-ness to avoid this
-		// erroneous complaints. Sigh.
-		Map &rhs = const_cast<Map &>(constRhs);
-		initBuckets(rhs.size());
-		rhs.mapAll<Map<ValueType> >(AddToMap, *this);	// add by using mapping function
+		allocateTable(rhs.capacity);
+		numEntries = rhs.numEntries;
+		for (int i = 0; i < capacity; i++) {
+			meta[i] = rhs.meta[i];
+			if (meta[i].distance != 0)
+				entries[i] = rhs.entries[i];
+		}
 	}	
 		
 
@@ -0,0 +1,200 @@
+/*
+ * File: nodepool.h
+ * ----------------
+ * This interface file contains the NodePool class template, an
+ * allocator for the nodes of linked structures such as the BST.
+ */
+
+#ifndef _nodepool_h
+#define _nodepool_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "vector.h"
+#include <new>
+
+/*
+ * Class: NodePool
+ * ---------------
+ * This interface defines a class template that hands out storage for
+ * one NodeType at a time from a few large blocks ("slabs") rather
+ * than calling new for every node. Nodes allocated one after another
+ * sit next to each other in memory, so a structure that is built in
+ * one go is walked through cache lines rather than all over the heap.
+ * A node given back with release goes on a free list and is handed out
+ * again before any fresh storage. The pool does not construct or
+ * destroy nodes; the client does that with placement new and an
+ * explicit destructor call, as in
+ *
+ *	nodeT *t = new (pool.allocate()) nodeT;
+ *	. . .
+ *	t->~nodeT();
+ *	pool.release(t);
+ */
+template <typename NodeType>
+  class NodePool {
+	public:
+
+		/*
+		 * Constructor: NodePool
+		 * Usage: NodePool<nodeT> pool;
+		 * ----------------------------
+		 * The constructor initializes an empty pool. No storage is
+		 * allocated until the first node is.
+		 */
+		NodePool();
+
+		/*
+		 * Destructor: ~NodePool
+		 * Usage: (implicit)
+		 * -----------------
+		 * The destructor frees all of the pool's slabs. Any nodes still
+		 * in use must have been destroyed by then.
+		 */
+		~NodePool();
+
+		/*
+		 * Member function: allocate
+		 * Usage: void *storage = pool.allocate();
+		 * ---------------------------------------
+		 * This member function returns uninitialized storage for one
+		 * NodeType.
+		 */
+		void *allocate();
+
+		/*
+		 * Member function: release
+		 * Usage: pool.release(node);
+		 * --------------------------
+		 * This member function gives back the storage of a node, which
+		 * must already have been destroyed, for a later allocate to reuse.
+		 */
+		void release(void *node);
+
+		/*
+		 * Member function: clear
+		 * Usage: pool.clear();
+		 * --------------------
+		 * This member function frees every slab at once, which takes one
+		 * delete per slab however many nodes were in it. The nodes must
+		 * already have been destroyed (or need no destructor), and none
+		 * of their storage may be used again.
+		 */
+		void clear();
+
+		/*
+		 * Member function: reserve
+		 * Usage: pool.reserve(numCities);
+		 * -------------------------------
+		 * This member function makes sure the next count allocations
+		 * come from a single slab, e.g. before a tree of known size is
+		 * built.
+		 */
+		void reserve(int count);
+
+	private:
+		DISALLOW_COPYING(NodePool)
+
+		/*
+		 * The free list is threaded through the released nodes
+		 * themselves, which are at least as large as a pointer.
+		 */
+		struct freeNodeT {
+			freeNodeT *next;
+		};
+
+		static const int FirstSlabSize = 32;		// in nodes
+		static const int MaxSlabSize = 65536;		// in nodes
+
+		Vector<char *> slabs;
+		char *nextFree;				// the first unused node in the newest slab
+		char *slabEnd;				// the end of the newest slab
+		int nextSlabSize;			// the number of nodes in the next slab allocated
+		freeNodeT *freeList;		// nodes given back by release
+
+		void addSlab(int count);
+  };
+
+
+/*
+ * NodePool class implementation
+ * -----------------------------
+ * Slabs start small, so that a set of a handful of elements costs
+ * little, and double up to MaxSlabSize nodes, so that a tree of
+ * millions of nodes takes a few dozen allocations. The unused tail of
+ * a slab is simply abandoned when reserve starts a new one.
+ */
+
+template <typename NodeType>
+  NodePool<NodeType>::NodePool()
+	{
+		nextFree = slabEnd = NULL;
+		nextSlabSize = FirstSlabSize;
+		freeList = NULL;
+	}
+
+template <typename NodeType>
+  NodePool<NodeType>::~NodePool()
+	{
+		clear();
+	}
+
+template <typename NodeType>
+ inline void *NodePool<NodeType>::allocate()
+	{
+		if (freeList != NULL) {
+			freeNodeT *node = freeList;
+			freeList = node->next;
+			return node;
+		}
+		if (nextFree == slabEnd) {
+			addSlab(nextSlabSize);
+			if (nextSlabSize < MaxSlabSize) nextSlabSize *= 2;
+		}
+		void *node = nextFree;
+		nextFree += sizeof(NodeType);
+		return node;
+	}
+
+template <typename NodeType>
+ inline void NodePool<NodeType>::release(void *node)
+	{
+		freeNodeT *freeNode = static_cast<freeNodeT *>(node);
+		freeNode->next = freeList;
+		freeList = freeNode;
+	}
+
+template <typename NodeType>
+  void NodePool<NodeType>::clear()
+	{
+		for (int i = 0; i < slabs.size(); i++)
+			::operator delete(slabs[i]);
+		slabs.clear();
+		nextFree = slabEnd = NULL;
+		nextSlabSize = FirstSlabSize;
+		freeList = NULL;
+	}
+
+template <typename NodeType>
+  void NodePool<NodeType>::reserve(int count)
+	{
+		if (count > (slabEnd - nextFree) / int(sizeof(NodeType)))
+			addSlab(count);
+	}
+
+/*
+ * Private member function: addSlab
+ * --------------------------------
+ * Allocates a slab of count nodes and makes it the one allocate takes
+ * nodes from.
+ */
+template <typename NodeType>
+  void NodePool<NodeType>::addSlab(int count)
+	{
+		char *slab = static_cast<char *>(::operator new(sizeof(NodeType) * size_t(count)));
+		slabs.add(slab);
+		nextFree = slab;
+		slabEnd = slab + sizeof(NodeType) * size_t(count);
+	}
+
+#endif
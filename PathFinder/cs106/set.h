@@ -50,6 +50,20 @@ template <typename ElemType>
 		 * elements to determine ordering.
 		 */
 	    Set(int (cmpFn)(ElemType, ElemType) = OperatorCmp);
+
+
+		/*
+		 * Constructor: Set
+		 * Usage: Set<int> set(numbers);
+		 *        Set<student> students(roster, CompareStudentsById);
+		 * ----------------------------------------------------------
+		 * This constructor initializes a set holding the elements of
+		 * the vector, ordered by the optional comparison function as
+		 * above. The vector is sorted once (or not at all if it is in
+		 * order already) and the set is built from it in one pass,
+		 * which is much faster than adding the elements one at a time.
+		 */
+	    explicit Set(Vector<ElemType> & elems, int (cmpFn)(ElemType, ElemType) = OperatorCmp);
 	    
 	    
 		/*
@@ -89,6 +103,19 @@ template <typename ElemType>
 		 * Otherwise, the value is added and set's size increases by one.
 		 */
 		void add(ElemType elem);	
+
+
+		/*
+		 * Member function: addAll
+		 * Usage: set.addAll(elems);
+		 * -------------------------
+		 * This member function adds all of the elements of the vector to
+		 * this set, as if each was passed to add in turn. Adding many
+		 * elements at once is done by sorting them and merging them with
+		 * the set's contents, as unionWith does.
+		 */
+		void addAll(Vector<ElemType> & elems);
+
 		
 		/*
 		 * Member function: remove
@@ -155,6 +182,12 @@ template <typename ElemType>
 		 * set.unionWith(set2);  Adds all elements from set2 to this set.
 		 * set.intersect(set2);  Removes any element not in set2 from this set.
 		 * set.subtract(set2);   Removes all element in set2 from this set.
+		 *
+		 * When the sets are of similar size, each of these walks the two
+		 * sets in order side by side and rebuilds this set from the
+		 * result, in time proportional to the sizes of the two sets
+		 * together. When one set is much smaller, its elements are looked
+		 * up in the other one at a time instead. 
 	 	*/    
 	 	void unionWith(Set & otherSet);
 	    void intersect(Set & otherSet);
@@ -271,6 +304,9 @@ template <typename ElemType>
 	private:
 		BST<ElemType> bst;
 		int (*cmpFn)(ElemType, ElemType);
+
+		void collect(Vector<ElemType> & elems);
+		static bool mergeIsCheaper(int count, int treeSize);
 			
 };
 	
@@ -281,6 +317,14 @@ template <typename ElemType>
 	}
 
 
+template <typename ElemType>
+  Set<ElemType>::Set(Vector<ElemType> & elems, int (cmp)(ElemType, ElemType)) : bst(cmp)
+	{
+	    cmpFn = cmp;
+	    bst.build(elems);
+	}
+
+
 template <typename ElemType>
   Set<ElemType>::~Set()
 	{
@@ -306,6 +350,21 @@ template <typename ElemType>
 	}
 
 
+template <typename ElemType>
+  void Set<ElemType>::addAll(Vector<ElemType> & elems)
+	{
+		if (isEmpty()) {
+			bst.build(elems);
+		} else if (mergeIsCheaper(elems.size(), size())) {
+			Set other(elems, cmpFn);
+			unionWith(other);
+		} else {
+			for (int i = 0; i < elems.size(); i++)
+				add(elems[i]);
+		}
+	}
+
+
 template <typename ElemType>
   void Set<ElemType>::remove(ElemType element)
 	{
@@ -332,12 +391,53 @@ template <typename ElemType>
 	    bst.clear();
 	}
 
+template <typename ElemType>
+  static void AddToVector(ElemType elem, Vector<ElemType> &vec)
+	{
+		vec.add(elem);
+	}
+
+/*
+ * Private member function: collect
+ * Usage: collect(elems);
+ * ----------------------
+ * Adds the elements of this set to the vector in order.
+ */
+template <typename ElemType>
+  void Set<ElemType>::collect(Vector<ElemType> & elems)
+	{
+		elems.reserve(elems.size() + size());
+		mapAll<Vector<ElemType> >(AddToVector, elems);
+	}
+
+/*
+ * Private member function: mergeIsCheaper
+ * Usage: if (mergeIsCheaper(otherSet.size(), size())) . . .
+ * ---------------------------------------------------------
+ * Decides how to combine two sets. Merging them costs about one step
+ * per element of both; going through count elements of one and
+ * looking each up in a tree of treeSize costs about count times the
+ * depth of the tree.
+ */
+template <typename ElemType>
+  bool Set<ElemType>::mergeIsCheaper(int count, int treeSize)
+	{
+		int depth = 1;
+		while (depth < 31 && (1 << depth) <= treeSize)
+			depth++;
+		return (double(count) * depth >= double(count) + treeSize);
+	}
+
 /*
  * Implementation notes: Set operations
  * ------------------------------------
- * The code for equals, isSubsetOf, unionWith, intersect, and subtract
- * is similar in structure.  Each one uses an iterator to walk over
- * one (or both) sets, doing add/remove/comparision.
+ * The code for equals and isSubsetOf uses an iterator to walk over
+ * one (or both) sets, doing comparisions. unionWith, intersect, and
+ * subtract either do the same with add/remove, or, when the sets are
+ * of similar size, collect both sets in order and merge the two
+ * vectors as merge sort does, then rebuild the tree from the result.
+ * Where both sets hold an equal element, unionWith keeps the one from
+ * otherSet, as add would.
  */
 
 template <typename ElemType>
@@ -368,30 +468,87 @@ template <typename ElemType>
   void Set<ElemType>::unionWith(Set & otherSet)
 	{
 		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to unionWith doesn't have same comparison function");
-		Iterator itr = otherSet.iterator();
-		while (itr.hasNext())
-			add(itr.next());
+		if (!mergeIsCheaper(otherSet.size(), size())) {
+			Iterator itr = otherSet.iterator();
+			while (itr.hasNext())
+				add(itr.next());
+			return;
+		}
+		Vector<ElemType> mine, theirs, merged;
+		collect(mine);
+		otherSet.collect(theirs);
+		merged.reserve(mine.size() + theirs.size());
+		int i = 0, j = 0;
+		while (i < mine.size() && j < theirs.size()) {
+			int sign = cmpFn(mine[i], theirs[j]);
+			if (sign < 0) {
+				merged.add(mine[i++]);
+			} else {
+				if (sign == 0) i++;
+				merged.add(theirs[j++]);
+			}
+		}
+		while (i < mine.size()) merged.add(mine[i++]);
+		while (j < theirs.size()) merged.add(theirs[j++]);
+		bst.build(merged);
 	}
 
 template <typename ElemType>
   void Set<ElemType>::intersect(Set & otherSet)
 	{
 		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to intersect doesn't have same comparison function");
-		Iterator itr = iterator();
-		while (itr.hasNext()) {
-			ElemType elem = itr.next();
-			if (!otherSet.contains(elem))
-				remove(elem);
+		if (!mergeIsCheaper(size(), otherSet.size())) {
+			Iterator itr = iterator();
+			while (itr.hasNext()) {
+				ElemType elem = itr.next();
+				if (!otherSet.contains(elem))
+					remove(elem);
+			}
+			return;
+		}
+		Vector<ElemType> mine, theirs, merged;
+		collect(mine);
+		otherSet.collect(theirs);
+		int i = 0, j = 0;
+		while (i < mine.size() && j < theirs.size()) {
+			int sign = cmpFn(mine[i], theirs[j]);
+			if (sign < 0) {
+				i++;
+			} else if (sign > 0) {
+				j++;
+			} else {
+				merged.add(mine[i++]);
+				j++;
+			}
 		}
+		bst.build(merged);
 	}
 
 template <typename ElemType>
   void Set<ElemType>::subtract(Set & otherSet)
 	{
 		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to subtract doesn't have same comparison function");
-		Iterator itr = otherSet.iterator();
-		while (itr.hasNext())
-			remove(itr.next());
+		if (!mergeIsCheaper(otherSet.size(), size())) {
+			Iterator itr = otherSet.iterator();
+			while (itr.hasNext())
+				remove(itr.next());
+			return;
+		}
+		Vector<ElemType> mine, theirs, merged;
+		collect(mine);
+		otherSet.collect(theirs);
+		int i = 0, j = 0;
+		while (i < mine.size() && j < theirs.size()) {
+			int sign = cmpFn(mine[i], theirs[j]);
+			if (sign < 0) {
+				merged.add(mine[i++]);
+			} else {
+				if (sign == 0) i++;
+				j++;
+			}
+		}
+		while (i < mine.size()) merged.add(mine[i++]);
+		bst.build(merged);
 	}
 
 	
@@ -434,14 +591,8 @@ template <typename ElemType>
 		return Iterator(this);
 	}
 
-		
 
-template <typename ElemType>
-  static void AddToVector(ElemType elem, Vector<ElemType> &vec)
-	{
-		vec.add(elem);
-	}
-	
+
 template <typename ElemType> 
   Set<ElemType>::Iterator::Iterator(Set *setptr) : elems(setptr->size())
 	{
@@ -11,6 +11,19 @@
 #define _vector_h_
 
 #include "genlib.h"
+#include <new>
+
+/*
+ * VECTOR_MOVE(x) moves x where the compiler supports it and copies it
+ * otherwise, which lets the implementation below be written once.
+ */
+#if __cplusplus >= 201103L
+#include <utility>
+#define VECTOR_HAS_MOVE
+#define VECTOR_MOVE(x) std::move(x)
+#else
+#define VECTOR_MOVE(x) (x)
+#endif
 
 
 /*
@@ -163,7 +176,77 @@ template <typename ElemType>
 		 * vector is made empty and will have size() = 0.
 		 */	
 		void clear();
-		
+
+
+		/*
+		 * Member function: reserve
+		 * Usage: vec.reserve(numCities);
+		 * ------------------------------
+		 * This member function makes room for at least count elements,
+		 * so that adding up to that many does not require any internal
+		 * reallocation. It never changes the size and never shrinks the
+		 * vector's storage.
+		 */
+		void reserve(int count);
+
+
+		/*
+		 * Member function: capacity
+		 * Usage: if (vec.size() == vec.capacity())...
+		 * -------------------------------------------
+		 * This member function returns the number of elements this
+		 * vector has room for before it must reallocate.
+		 */
+		int capacity();
+
+
+		/*
+		 * Member function: shrinkToFit
+		 * Usage: vec.shrinkToFit();
+		 * -------------------------
+		 * This member function releases any storage beyond what the
+		 * current elements need, e.g. once a vector has been filled and
+		 * will not grow again.
+		 */
+		void shrinkToFit();
+
+
+		/*
+		 * Member function: emplace
+		 * Usage: lines.emplace(buffer, length);
+		 *        pathT &path = paths.emplace();
+		 * ---------------------------------------
+		 * This member function constructs a new element at the end of
+		 * this vector directly from the arguments, which are passed to
+		 * the element's constructor, and returns a reference to it. With
+		 * no arguments the element is value-initialized (zeroed for
+		 * built-in types and plain structs) and can then be filled in
+		 * place, which saves building it elsewhere and copying it in.
+		 * Without C++11 up to three arguments are accepted.
+		 */
+#ifdef VECTOR_HAS_MOVE
+		template <typename... ArgTypes>
+		ElemType &emplace(ArgTypes &&... args);
+#else
+		ElemType &emplace();
+		template <typename A1>
+		ElemType &emplace(const A1 &a1);
+		template <typename A1, typename A2>
+		ElemType &emplace(const A1 &a1, const A2 &a2);
+		template <typename A1, typename A2, typename A3>
+		ElemType &emplace(const A1 &a1, const A2 &a2, const A3 &a3);
+#endif
+
+
+		/*
+		 * Member function: swap
+		 * Usage: vec.swap(other);
+		 * -----------------------
+		 * This member function exchanges the contents of this vector and
+		 * the other one without copying any elements.
+		 */
+		void swap(Vector &other);
+
 
 		/*
 		 * Deep copying support
@@ -180,15 +263,35 @@ template <typename ElemType>
 		 */
 		const Vector &operator=(const Vector &rhs); 
 		Vector(const Vector &rhs);
-		
-		
+
+		/*
+		 * Move support
+		 * ------------
+		 * With C++11, a vector that is about to be thrown away (e.g. one
+		 * returned by value) hands its storage over rather than being
+		 * copied, leaving the original empty. The vector also moves its
+		 * elements rather than copying them when it grows or shifts them.
+		 */
+#ifdef VECTOR_HAS_MOVE
+		Vector &operator=(Vector &&rhs);
+		Vector(Vector &&rhs);
+#endif
+
+
 	private:
 		ElemType *elements;
 		int numAllocated, numUsed;
 
 		void checkRange(int index, const char *msg);
-		void enlargeCapacity();
+		int grownCapacity();
+		void reallocate(int newCapacity);
+		ElemType *finishAppend(ElemType *storage);
+		void destroyAll();
 		void copyInternalData(const Vector &other);
+
+		static ElemType *allocate(int count);
+		static void deallocate(ElemType *storage);
+		static void relocate(ElemType *from, int count, ElemType *to);
 	};
 	
 	
@@ -211,7 +314,10 @@ template <typename ElemType>
  * ---------------------------
  * The Vector is internally managed as a dynamic array of elements.  It tracks capacity
  * (numAllocated) separately from size (numUsed).  All access is bounds-checked for
- * safety. 
+ * safety. The array is raw storage: only the first numUsed slots hold constructed
+ * elements, the rest are never constructed, and elements are constructed in place with
+ * placement new and destroyed explicitly. When the array grows, elements are moved
+ * (copied before C++11) into the new one once each and nothing is default-constructed.
  */
 
 #include "strutils.h" // for IntegerToString calls in error messages
@@ -220,15 +326,16 @@ template <typename ElemType>
 template <typename ElemType> 
   Vector<ElemType>::Vector(int capacity)
 	{
-		elements = new ElemType[capacity];
-		numAllocated = capacity;
+		elements = allocate(capacity);
+		numAllocated = (capacity > 0 ? capacity : 0);
 		numUsed = 0;
 	}
 	
 template <typename ElemType> 
   Vector<ElemType>::~Vector()
 	{
-		delete[] elements;
+		destroyAll();
+		deallocate(elements);
 	}
 	
 template <typename ElemType> 
@@ -254,7 +361,7 @@ template <typename ElemType>
   void Vector<ElemType>::setAt(int index, ElemType elem) 
 	{
 		checkRange(index, "setAt");
-		elements[index] = elem;
+		elements[index] = VECTOR_MOVE(elem);
 	}
 	
 /* Private member function: checkRange
@@ -282,18 +389,38 @@ template <typename ElemType>
 template <typename ElemType> 
   void Vector<ElemType>::add(ElemType elem)
 	{ 
-		insertAt(numUsed, elem);	// add is just a special-case of insertAt
+		emplace(VECTOR_MOVE(elem));
 	}
-					
+
+/*
+ * Implementation notes: insertAt
+ * ------------------------------
+ * If the array is full, the new element and the old ones go straight
+ * to their places in the new array, so nothing is moved twice.
+ * Otherwise the last element is moved into the first unused slot and
+ * the others each move up one slot into the one it vacated.
+ */
 template <typename ElemType> 
   void Vector<ElemType>::insertAt(int index, ElemType elem) 
 	{
-		if (numAllocated == numUsed) 
-			enlargeCapacity(); 
 		if (index != numUsed) checkRange(index, "insertAt"); 
-		for (int i = numUsed; i > index; i--)
-			elements[i] = elements[i-1];
-		elements[index] = elem;
+		if (numAllocated == numUsed) {
+			int newCapacity = grownCapacity();
+			ElemType *newArray = allocate(newCapacity);
+			new (newArray + index) ElemType(VECTOR_MOVE(elem));
+			relocate(elements, index, newArray);
+			relocate(elements + index, numUsed - index, newArray + index + 1);
+			deallocate(elements);
+			elements = newArray;
+			numAllocated = newCapacity;
+		} else if (index == numUsed) {
+			new (elements + numUsed) ElemType(VECTOR_MOVE(elem));
+		} else {
+			new (elements + numUsed) ElemType(VECTOR_MOVE(elements[numUsed-1]));
+			for (int i = numUsed-1; i > index; i--)
+				elements[i] = VECTOR_MOVE(elements[i-1]);
+			elements[index] = VECTOR_MOVE(elem);
+		}
 		numUsed++;
 	}
 	
@@ -302,18 +429,106 @@ template <typename ElemType>
 	{
 		checkRange(index, "removeAt"); 
 		for (int i = index; i < numUsed-1; i++)
-			elements[i] = elements[i+1];
+			elements[i] = VECTOR_MOVE(elements[i+1]);
+		elements[numUsed-1].~ElemType();
 		numUsed--;
 	}
 	
 template <typename ElemType> 
   void Vector<ElemType>::clear() 
 	{
-		delete[] elements;
+		destroyAll();
+		deallocate(elements);
 		elements = NULL;
 		numUsed = numAllocated = 0;
 	}
 
+template <typename ElemType> 
+  void Vector<ElemType>::reserve(int count) 
+	{
+		if (count > numAllocated) reallocate(count);
+	}
+
+template <typename ElemType> 
+  int Vector<ElemType>::capacity() 
+	{
+		return numAllocated;
+	}
+
+template <typename ElemType> 
+  void Vector<ElemType>::shrinkToFit() 
+	{
+		if (numAllocated > numUsed) reallocate(numUsed);
+	}
+
+
+/*
+ * Implementation notes: emplace
+ * -----------------------------
+ * When the array is full, the new element is constructed in the new
+ * array before the old elements are moved out of the old one, so the
+ * arguments may safely refer to elements of this vector.
+ */
+#ifdef VECTOR_HAS_MOVE
+template <typename ElemType> 
+template <typename... ArgTypes>
+  ElemType &Vector<ElemType>::emplace(ArgTypes &&... args)
+	{
+		ElemType *storage = (numUsed == numAllocated ? allocate(grownCapacity()) : elements);
+		new (storage + numUsed) ElemType(std::forward<ArgTypes>(args)...);
+		return *finishAppend(storage);
+	}
+#else
+template <typename ElemType> 
+  ElemType &Vector<ElemType>::emplace()
+	{
+		ElemType *storage = (numUsed == numAllocated ? allocate(grownCapacity()) : elements);
+		new (storage + numUsed) ElemType();
+		return *finishAppend(storage);
+	}
+
+template <typename ElemType> 
+template <typename A1>
+  ElemType &Vector<ElemType>::emplace(const A1 &a1)
+	{
+		ElemType *storage = (numUsed == numAllocated ? allocate(grownCapacity()) : elements);
+		new (storage + numUsed) ElemType(a1);
+		return *finishAppend(storage);
+	}
+
+template <typename ElemType> 
+template <typename A1, typename A2>
+  ElemType &Vector<ElemType>::emplace(const A1 &a1, const A2 &a2)
+	{
+		ElemType *storage = (numUsed == numAllocated ? allocate(grownCapacity()) : elements);
+		new (storage + numUsed) ElemType(a1, a2);
+		return *finishAppend(storage);
+	}
+
+template <typename ElemType> 
+template <typename A1, typename A2, typename A3>
+  ElemType &Vector<ElemType>::emplace(const A1 &a1, const A2 &a2, const A3 &a3)
+	{
+		ElemType *storage = (numUsed == numAllocated ? allocate(grownCapacity()) : elements);
+		new (storage + numUsed) ElemType(a1, a2, a3);
+		return *finishAppend(storage);
+	}
+#endif
+
+
+template <typename ElemType> 
+  void Vector<ElemType>::swap(Vector &other) 
+	{
+		ElemType *otherElements = other.elements;
+		int otherAllocated = other.numAllocated, otherUsed = other.numUsed;
+		other.elements = elements;
+		other.numAllocated = numAllocated;
+		other.numUsed = numUsed;
+		elements = otherElements;
+		numAllocated = otherAllocated;
+		numUsed = otherUsed;
+	}
+
 
 template <typename ElemType> 
   const Vector<ElemType> &Vector<ElemType>::operator=(const Vector &rhs) 
@@ -330,22 +545,89 @@ template <typename ElemType>
 	{
 		copyInternalData(rhs);					
 	}	
-	
-	
-/* Private member function: enlargeCapacity
- * -----------------------------------------
- * Doubles the current capacity of the vector's internal storage,
- * copying all existing values.
+
+#ifdef VECTOR_HAS_MOVE
+template <typename ElemType> 
+  Vector<ElemType> &Vector<ElemType>::operator=(Vector &&rhs) 
+	{
+		if (this != &rhs) {
+			clear();
+			elements = rhs.elements;
+			numAllocated = rhs.numAllocated;
+			numUsed = rhs.numUsed;
+			rhs.elements = NULL;
+			rhs.numAllocated = rhs.numUsed = 0;
+		}
+		return *this;
+	}
+
+template <typename ElemType> 
+  Vector<ElemType>::Vector(Vector &&rhs)
+	{
+		elements = rhs.elements;
+		numAllocated = rhs.numAllocated;
+		numUsed = rhs.numUsed;
+		rhs.elements = NULL;
+		rhs.numAllocated = rhs.numUsed = 0;
+	}
+#endif
+
+
+/* Private member function: grownCapacity
+ * --------------------------------------
+ * Returns the capacity to grow a full vector to: double the current
+ * one, so that adding n elements one at a time moves each element a
+ * constant number of times on average.
  */
 template <typename ElemType> 
-  void Vector<ElemType>::enlargeCapacity() 
+  int Vector<ElemType>::grownCapacity() 
 	{
-		numAllocated = (numAllocated == 0 ? 10 : numAllocated*2);
-		ElemType *newArray = new ElemType[numAllocated];
-		for (int i = 0; i < numUsed; i++)
-			newArray[i] = elements[i];
-		delete[] elements;
+		return (numAllocated == 0 ? 10 : numAllocated*2);
+	}
+
+/* Private member function: reallocate
+ * -----------------------------------
+ * Moves the elements to a new array with room for newCapacity
+ * elements, which must be at least size().
+ */
+template <typename ElemType> 
+  void Vector<ElemType>::reallocate(int newCapacity) 
+	{
+		ElemType *newArray = allocate(newCapacity);
+		relocate(elements, numUsed, newArray);
+		deallocate(elements);
 		elements = newArray;
+		numAllocated = newCapacity;
+	}
+
+/* Private member function: finishAppend
+ * -------------------------------------
+ * Completes an append once the new element has been constructed at
+ * index numUsed of storage, which is either the current array or a
+ * new one of grownCapacity() elements that the others still have to
+ * be moved to. Returns the new element.
+ */
+template <typename ElemType> 
+ inline ElemType *Vector<ElemType>::finishAppend(ElemType *storage) 
+	{
+		if (storage != elements) {
+			relocate(elements, numUsed, storage);
+			deallocate(elements);
+			numAllocated = grownCapacity();
+			elements = storage;
+		}
+		return elements + numUsed++;
+	}
+
+/* Private member function: destroyAll
+ * -----------------------------------
+ * Runs the destructor of every element, leaving the storage allocated.
+ */
+template <typename ElemType> 
+  void Vector<ElemType>::destroyAll() 
+	{
+		for (int i = 0; i < numUsed; i++)
+			elements[i].~ElemType();
 	}
 	
 	
@@ -358,14 +640,45 @@ template <typename ElemType>
 template <typename ElemType> 
   void Vector<ElemType>::copyInternalData(const Vector &other)
 	{
-		elements = new ElemType[other.numUsed];
+		elements = allocate(other.numUsed);
 		for (int i = 0; i < other.numUsed; i++)
-			elements[i] = other.elements[i];
+			new (elements + i) ElemType(other.elements[i]);
 		numUsed = other.numUsed;
 		numAllocated = other.numUsed;	
 	}
+
+
+/* Private static functions: allocate, deallocate, relocate
+ * --------------------------------------------------------
+ * allocate returns uninitialized storage for count elements, or NULL
+ * if count is not positive, and deallocate frees it. relocate moves
+ * count elements into uninitialized storage at to and destroys the
+ * originals, leaving the storage at from uninitialized.
+ */
+template <typename ElemType> 
+  ElemType *Vector<ElemType>::allocate(int count) 
+	{
+		if (count <= 0) return NULL;
+		return static_cast<ElemType *>(::operator new(sizeof(ElemType) * size_t(count)));
+	}
+
+template <typename ElemType> 
+  void Vector<ElemType>::deallocate(ElemType *storage) 
+	{
+		::operator delete(storage);
+	}
+
+template <typename ElemType> 
+  void Vector<ElemType>::relocate(ElemType *from, int count, ElemType *to) 
+	{
+		for (int i = 0; i < count; i++) {
+			new (to + i) ElemType(VECTOR_MOVE(from[i]));
+			from[i].~ElemType();
+		}
+	}
 		
 		
 	
+#undef VECTOR_MOVE
 
 #endif //_vector_h_
@@ -0,0 +1,251 @@
+/*
+ * File: edgesort.cpp
+ * ------------------
+ * Implementation of the parallel edge sorts declared in edgesort.h.
+ */
+
+#include "edgesort.h"
+#include "parallel.h"
+#include <cmath>
+
+/*
+ * Below this many edges per thread, starting threads costs more than
+ * it saves and the sort runs on the calling thread.
+ */
+static const int MinEdgesPerThread = 16384;
+
+static const int RadixBits = 8;
+static const int RadixSize = 1 << RadixBits;
+static const double MaxRadixRange = 4294967295.0;	// largest key that fits in 32 bits
+
+
+/* Parallel radix sort
+ * -------------------
+ * Each edge gets an unsigned key, its distance minus the smallest
+ * distance. Then one pass per byte of the largest key: every thread
+ * counts the digits in its slice, a prefix sum over (digit, thread)
+ * gives each thread its own starting slot for each digit, and the
+ * threads scatter their slices into the other buffer. Scattering each
+ * slice in order is what keeps the sort stable.
+ */
+
+struct radixSortT {
+	edgeT *src, *dst;
+	unsigned *keySrc, *keyDst;
+	int n;
+	int shift;
+	double minDistance;
+	int *counts;		// counts[thread * RadixSize + digit]
+};
+
+static void MakeKeys(int thread, int numThreads, radixSortT & sort)
+{
+	int start, end;
+	SplitRange(sort.n, thread, numThreads, start, end);
+	for (int i = start; i < end; i++) {
+		sort.keySrc[i] = (unsigned) (sort.src[i].distance - sort.minDistance);
+	}
+}
+
+static void CountDigits(int thread, int numThreads, radixSortT & sort)
+{
+	int start, end;
+	SplitRange(sort.n, thread, numThreads, start, end);
+	int *counts = sort.counts + thread * RadixSize;
+	for (int d = 0; d < RadixSize; d++) {
+		counts[d] = 0;
+	}
+	for (int i = start; i < end; i++) {
+		counts[(sort.keySrc[i] >> sort.shift) & (RadixSize - 1)]++;
+	}
+}
+
+static void ScatterDigits(int thread, int numThreads, radixSortT & sort)
+{
+	int start, end;
+	SplitRange(sort.n, thread, numThreads, start, end);
+	int *next = sort.counts + thread * RadixSize;
+	for (int i = start; i < end; i++) {
+		int slot = next[(sort.keySrc[i] >> sort.shift) & (RadixSize - 1)]++;
+		sort.dst[slot] = sort.src[i];
+		sort.keyDst[slot] = sort.keySrc[i];
+	}
+}
+
+static void RadixSortEdges(edgeT edges[], int n, double minDistance, double maxDistance, int numThreads)
+{
+	unsigned maxKey = (unsigned) (maxDistance - minDistance);
+	if (maxKey == 0) return;				// every edge has the same distance
+
+	radixSortT sort;
+	sort.src = edges;
+	sort.dst = new edgeT[n];
+	sort.keySrc = new unsigned[n];
+	sort.keyDst = new unsigned[n];
+	sort.n = n;
+	sort.minDistance = minDistance;
+	sort.counts = new int[numThreads * RadixSize];
+	RunInParallel(MakeKeys, sort, numThreads);
+
+	for (sort.shift = 0; sort.shift < 32 && (maxKey >> sort.shift) != 0; sort.shift += RadixBits) {
+		RunInParallel(CountDigits, sort, numThreads);
+		int total = 0;
+		for (int d = 0; d < RadixSize; d++) {			// turn the counts into starting slots
+			for (int t = 0; t < numThreads; t++) {
+				int count = sort.counts[t * RadixSize + d];
+				sort.counts[t * RadixSize + d] = total;
+				total += count;
+			}
+		}
+		RunInParallel(ScatterDigits, sort, numThreads);
+		edgeT *edgeSwap = sort.src;
+		sort.src = sort.dst;
+		sort.dst = edgeSwap;
+		unsigned *keySwap = sort.keySrc;
+		sort.keySrc = sort.keyDst;
+		sort.keyDst = keySwap;
+	}
+
+	if (sort.src != edges) {						// odd number of passes, result is in the spare buffer
+		for (int i = 0; i < n; i++) {
+			edges[i] = sort.src[i];
+		}
+		sort.dst = sort.src;
+	}
+	delete[] sort.dst;
+	delete[] sort.keySrc;
+	delete[] sort.keyDst;
+	delete[] sort.counts;
+}
+
+
+/* Parallel merge sort
+ * -------------------
+ * Every thread merge sorts its own slice, then the sorted slices are
+ * merged pairwise in rounds, with each merge of the round on its own
+ * thread, until one sorted run is left. Taking from the left run on
+ * ties keeps the sort stable.
+ */
+
+struct mergeSortT {
+	edgeT *edges, *temp;
+	int *bounds;		// run r is [bounds[r], bounds[r+1])
+	int numRuns;
+	int step;			// runs r and r+step are merged in this round
+};
+
+static void MergeRuns(edgeT from[], edgeT to[], int start, int middle, int end)
+{
+	int left = start, right = middle, out = start;
+	while (left < middle && right < end) {
+		if (from[right].distance < from[left].distance) {
+			to[out++] = from[right++];
+		} else {
+			to[out++] = from[left++];
+		}
+	}
+	while (left < middle) to[out++] = from[left++];
+	while (right < end) to[out++] = from[right++];
+}
+
+/* Function: MergeSortRange
+ * ------------------------
+ * Bottom-up merge sort of edges[start, end), using the same range of
+ * temp as scratch space. Runs of doubling width are merged back and
+ * forth between the two arrays.
+ */
+static void MergeSortRange(edgeT edges[], edgeT temp[], int start, int end)
+{
+	edgeT *from = edges, *to = temp;
+	for (int width = 1; width < end - start; width *= 2) {
+		for (int lo = start; lo < end; lo += 2 * width) {
+			int middle = (lo + width < end) ? lo + width : end;
+			int hi = (lo + 2 * width < end) ? lo + 2 * width : end;
+			MergeRuns(from, to, lo, middle, hi);
+		}
+		edgeT *swap = from;
+		from = to;
+		to = swap;
+	}
+	if (from != edges) {
+		for (int i = start; i < end; i++) {
+			edges[i] = from[i];
+		}
+	}
+}
+
+static void SortSlice(int thread, int /* numThreads */, mergeSortT & sort)
+{
+	MergeSortRange(sort.edges, sort.temp, sort.bounds[thread], sort.bounds[thread + 1]);
+}
+
+static void MergeSlicePair(int thread, int /* numThreads */, mergeSortT & sort)
+{
+	int left = thread * 2 * sort.step;
+	int right = left + sort.step;
+	if (right >= sort.numRuns) return;			// odd run out, nothing to merge with this round
+	int last = (right + sort.step < sort.numRuns) ? right + sort.step : sort.numRuns;
+	int start = sort.bounds[left], middle = sort.bounds[right], end = sort.bounds[last];
+	MergeRuns(sort.edges, sort.temp, start, middle, end);
+	for (int i = start; i < end; i++) {
+		sort.edges[i] = sort.temp[i];
+	}
+}
+
+static void MergeSortEdges(edgeT edges[], int n, int numThreads)
+{
+	mergeSortT sort;
+	sort.edges = edges;
+	sort.temp = new edgeT[n];
+	sort.numRuns = numThreads;
+	sort.bounds = new int[numThreads + 1];
+	for (int t = 0; t < numThreads; t++) {
+		int end;
+		SplitRange(n, t, numThreads, sort.bounds[t], end);
+	}
+	sort.bounds[numThreads] = n;
+	RunInParallel(SortSlice, sort, numThreads);
+	for (sort.step = 1; sort.step < sort.numRuns; sort.step *= 2) {
+		int pairs = (sort.numRuns + 2 * sort.step - 1) / (2 * sort.step);
+		RunInParallel(MergeSlicePair, sort, pairs);
+	}
+	delete[] sort.temp;
+	delete[] sort.bounds;
+}
+
+
+/* Function: ScanDistances
+ * -----------------------
+ * Finds the smallest and largest distance and returns whether every
+ * distance is a whole number.
+ */
+static bool ScanDistances(edgeT edges[], int n, double & minDistance, double & maxDistance)
+{
+	bool integral = true;
+	minDistance = maxDistance = (n > 0) ? edges[0].distance : 0;
+	for (int i = 0; i < n; i++) {
+		double distance = edges[i].distance;
+		if (distance != floor(distance)) integral = false;
+		if (distance < minDistance) minDistance = distance;
+		if (distance > maxDistance) maxDistance = distance;
+	}
+	return integral;
+}
+
+bool HasIntegerDistances(edgeT edges[], int n)
+{
+	double minDistance, maxDistance;
+	return ScanDistances(edges, n, minDistance, maxDistance) && maxDistance - minDistance <= MaxRadixRange;
+}
+
+void SortEdges(edgeT edges[], int n, int numThreads)
+{
+	if (n < 2) return;
+	numThreads = ChooseThreadCount(n, MinEdgesPerThread, numThreads);
+	double minDistance, maxDistance;
+	if (ScanDistances(edges, n, minDistance, maxDistance) && maxDistance - minDistance <= MaxRadixRange) {
+		RadixSortEdges(edges, n, minDistance, maxDistance, numThreads);
+	} else {
+		MergeSortEdges(edges, n, numThreads);
+	}
+}
@@ -0,0 +1,38 @@
+/*
+ * File: edgesort.h
+ * ----------------
+ * Sorting of edge lists by distance for the minimum spanning tree
+ * algorithms, spread across several threads.
+ */
+
+#ifndef _edgesort_h
+#define _edgesort_h
+
+#include "graph.h"
+
+
+/*
+ * Function: SortEdges
+ * Usage: SortEdges(edges, numEdges);
+ *        SortEdges(edges, numEdges, 4);
+ * -------------------------------------
+ * Sorts the array of edges into increasing order of distance. The
+ * sort is stable: edges of equal distance keep their relative order.
+ * When every distance is a whole number the edges are radix sorted
+ * on the integer distance; otherwise they are merge sorted. Either
+ * way the work is split across numThreads threads (GetThreadCount()
+ * if not given).
+ */
+void SortEdges(edgeT edges[], int n, int numThreads = 0);
+
+/*
+ * Function: HasIntegerDistances
+ * Usage: if (HasIntegerDistances(edges, n)) . . .
+ * -----------------------------------------------
+ * Returns true if every distance is a whole number and the range
+ * of distances fits in 32 bits, which is when SortEdges can use
+ * the radix sort.
+ */
+bool HasIntegerDistances(edgeT edges[], int n);
+
+#endif
@@ -0,0 +1,413 @@
+/*
+ * File: graph.cpp
+ * ---------------
+ * Implementation of the Graph class declared in graph.h.
+ */
+
+#include "graph.h"
+#include "strutils.h"
+#include <cstdlib> // for NULL
+#include <cstring>
+#include <cmath>
+#include <fstream>
+
+
+/* Snapshot format
+ * ---------------
+ * A snapshot holds the graph's flat arrays exactly as they are laid
+ * out in memory, so loading one is a matter of mapping the file and
+ * pointing at the arrays. It starts with a snapshotHeaderT, followed
+ * by these sections in order, each starting on a multiple of 8 bytes:
+ *
+ *	int nameStarts[numNodes + 1]	where each name starts in the name table
+ *	char names[nameBytes]			the names, each followed by a '\0', then the picture name
+ *	coordT locations[numNodes]		two doubles each
+ *	edgeT arcs[numArcs]				int from, int to, double distance
+ *	int offsets[numNodes + 1]
+ *	int targets[2 * numArcs]
+ *	double weights[2 * numArcs]
+ *
+ * The byte order mark lets a snapshot copied to a machine of the
+ * other byte order be rejected instead of misread. Any change to the
+ * layout must bump SnapshotVersion.
+ */
+
+static const char SnapshotMagic[8] = "PFGRAPH";
+static const int SnapshotVersion = 1;
+static const int SnapshotByteOrder = 0x01020304;
+
+struct snapshotHeaderT {
+	char magic[8];
+	int version;
+	int byteOrder;
+	int numNodes;
+	int numArcs;
+	int nameBytes;
+	int unused;				// pads the header to 32 bytes
+};
+
+struct snapshotLayoutT {
+	size_t nameStarts, names, locations, arcs, offsets, targets, weights;
+	size_t total;
+};
+
+static size_t AlignSection(size_t position)
+{
+	return (position + 7) & ~size_t(7);
+}
+
+static snapshotLayoutT SnapshotLayout(int numNodes, int numArcs, int nameBytes)
+{
+	snapshotLayoutT layout;
+	layout.nameStarts = AlignSection(sizeof(snapshotHeaderT));
+	layout.names = AlignSection(layout.nameStarts + (numNodes + 1) * sizeof(int));
+	layout.locations = AlignSection(layout.names + nameBytes);
+	layout.arcs = AlignSection(layout.locations + numNodes * sizeof(coordT));
+	layout.offsets = AlignSection(layout.arcs + numArcs * sizeof(edgeT));
+	layout.targets = AlignSection(layout.offsets + (numNodes + 1) * sizeof(int));
+	layout.weights = AlignSection(layout.targets + 2 * size_t(numArcs) * sizeof(int));
+	layout.total = layout.weights + 2 * size_t(numArcs) * sizeof(double);
+	return layout;
+}
+
+/* Writes a section, padded with zeros to the position it should end at. */
+static void WriteSection(ofstream & out, const void *data, size_t bytes, size_t & position, size_t end)
+{
+	static const char zeros[8] = { 0 };
+	if (bytes > 0) out.write((const char *) data, bytes);
+	position += bytes;
+	while (position < end) {
+		size_t pad = end - position < 8 ? end - position : 8;
+		out.write(zeros, pad);
+		position += pad;
+	}
+}
+
+
+Graph::Graph()
+{
+	nameStarts = NULL;
+	nameChars = NULL;
+	locations = NULL;
+	arcs = NULL;
+	offsets = NULL;
+	targets = NULL;
+	weights = NULL;
+	nodeCount = 0;
+	arcCount = 0;
+	namesIndexed = true;
+	distanceScale = -1;
+}
+
+Graph::~Graph()
+{
+	freeArrays();
+}
+
+void Graph::freeArrays()
+{
+	if (snapshot.isOpen()) {
+		snapshot.close();
+	} else {
+		delete[] nameStarts;
+		delete[] nameChars;
+		delete[] locations;
+		delete[] arcs;
+		delete[] offsets;
+		delete[] targets;
+		delete[] weights;
+	}
+	nameStarts = NULL;
+	nameChars = NULL;
+	locations = NULL;
+	arcs = NULL;
+	offsets = NULL;
+	targets = NULL;
+	weights = NULL;
+}
+
+void Graph::clear()
+{
+	freeArrays();
+	string().swap(stagedNames);
+	stagedStarts.clear();
+	stagedLocations.clear();
+	stagedArcs.clear();
+	nameToId.clear();
+	pictureName = "";
+	nodeCount = 0;
+	arcCount = 0;
+	namesIndexed = true;
+	distanceScale = -1;
+}
+
+int Graph::addNode(string name, coordT location)
+{
+	if (offsets != NULL) Error("Nodes cannot be added to a graph that has been built.");
+	int id = nodeCount++;
+	int start = stagedNames.length();
+	stagedNames.append(name);
+	stagedNames += '\0';
+	stagedStarts.add(start);
+	stagedLocations.add(location);
+	nameToId.setNames(stagedNames.data());
+	nameToId.put(start, name.length(), id);
+	return id;
+}
+
+void Graph::addArc(int from, int to, double distance)
+{
+	if (offsets != NULL) Error("Arcs cannot be added to a graph that has been built.");
+	if (from < 0 || from >= numNodes() || to < 0 || to >= numNodes())
+		Error("Arc refers to a node that is not in the graph.");
+	edgeT arc;
+	arc.from = from;
+	arc.to = to;
+	arc.distance = distance;
+	stagedArcs.add(arc);
+	arcCount++;
+}
+
+
+/* Implementation notes: build
+ * ---------------------------
+ * The name table, locations and arcs are copied out of the staging
+ * storage first, and the name index is pointed at the new name table.
+ * For the adjacency, the first pass counts the degree of every node, a
+ * prefix sum turns the degrees into starting offsets, and the second
+ * pass drops each arc into the next free slot of both of its endpoints.
+ * The "next" array is a copy of the offsets that is advanced as slots
+ * fill up.
+ */
+void Graph::build()
+{
+	freeArrays();
+	int n = numNodes();
+	int m = numArcs();
+
+	int *starts = new int[n + 1];
+	coordT *where = new coordT[n];
+	for (int i = 0; i < n; i++) {
+		starts[i] = stagedStarts[i];
+		where[i] = stagedLocations[i];
+	}
+	starts[n] = stagedNames.length();
+	char *chars = new char[starts[n] + 1];
+	memcpy(chars, stagedNames.data(), starts[n]);
+	nameToId.setNames(chars);
+	edgeT *arcArray = new edgeT[m];
+	for (int i = 0; i < m; i++) {
+		arcArray[i] = stagedArcs[i];
+	}
+	string().swap(stagedNames);
+	stagedStarts.clear();
+	stagedLocations.clear();
+	stagedArcs.clear();
+
+	int *first = new int[n + 1];
+	int *to = new int[2 * m];
+	double *length = new double[2 * m];
+	for (int i = 0; i <= n; i++) {
+		first[i] = 0;
+	}
+	for (int i = 0; i < m; i++) {
+		first[arcArray[i].from + 1]++;
+		first[arcArray[i].to + 1]++;
+	}
+	for (int i = 0; i < n; i++) {
+		first[i + 1] += first[i];
+	}
+
+	int *next = new int[n];
+	for (int i = 0; i < n; i++) {
+		next[i] = first[i];
+	}
+	for (int i = 0; i < m; i++) {
+		edgeT arc = arcArray[i];
+		int slot = next[arc.from]++;
+		to[slot] = arc.to;
+		length[slot] = arc.distance;
+		slot = next[arc.to]++;
+		to[slot] = arc.from;
+		length[slot] = arc.distance;
+	}
+	delete[] next;
+
+	nameStarts = starts;
+	nameChars = chars;
+	locations = where;
+	arcs = arcArray;
+	offsets = first;
+	targets = to;
+	weights = length;
+}
+
+void Graph::setPictureName(string name)
+{
+	pictureName = name;
+}
+
+string Graph::getPictureName()
+{
+	return pictureName;
+}
+
+void Graph::saveSnapshot(string filename)
+{
+	if (offsets == NULL) Error("A graph must be built before it can be saved.");
+	int n = numNodes();
+	int m = numArcs();
+	snapshotHeaderT header;
+	memset(&header, 0, sizeof header);
+	memcpy(header.magic, SnapshotMagic, sizeof header.magic);
+	header.version = SnapshotVersion;
+	header.byteOrder = SnapshotByteOrder;
+	header.numNodes = n;
+	header.numArcs = m;
+	header.nameBytes = nameStarts[n] + pictureName.length() + 1;
+	snapshotLayoutT layout = SnapshotLayout(n, m, header.nameBytes);
+
+	ofstream out(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if (out.fail()) Error("Cannot write the snapshot " + filename);
+	size_t position = 0;
+	WriteSection(out, &header, sizeof header, position, layout.nameStarts);
+	WriteSection(out, nameStarts, (n + 1) * sizeof(int), position, layout.names);
+	WriteSection(out, nameChars, nameStarts[n], position, position);
+	WriteSection(out, pictureName.c_str(), pictureName.length() + 1, position, layout.locations);
+	WriteSection(out, locations, n * sizeof(coordT), position, layout.arcs);
+	WriteSection(out, arcs, m * sizeof(edgeT), position, layout.offsets);
+	WriteSection(out, offsets, (n + 1) * sizeof(int), position, layout.targets);
+	WriteSection(out, targets, 2 * size_t(m) * sizeof(int), position, layout.weights);
+	WriteSection(out, weights, 2 * size_t(m) * sizeof(double), position, layout.total);
+	out.close();
+	if (out.fail()) Error("Cannot write the snapshot " + filename);
+}
+
+/* Implementation notes: loadSnapshot
+ * ----------------------------------
+ * Only the header is checked, plus the size of the file against the
+ * size the header implies, so that loading stays O(1). The names are
+ * not put into nameToId until findNode is first called, and even then
+ * the index only records where each one lies in the mapped table.
+ */
+void Graph::loadSnapshot(string filename)
+{
+	clear();
+	if (!snapshot.open(filename)) Error("Cannot open the snapshot " + filename);
+	const char *data = snapshot.data();
+	snapshotHeaderT header;
+	if (snapshot.size() < sizeof header) {
+		snapshot.close();
+		Error(filename + " is too short to be a snapshot.");
+	}
+	memcpy(&header, data, sizeof header);
+	if (memcmp(header.magic, SnapshotMagic, sizeof header.magic) != 0) {
+		snapshot.close();
+		Error(filename + " is not a snapshot.");
+	}
+	if (header.byteOrder != SnapshotByteOrder) {
+		snapshot.close();
+		Error(filename + " was written on a machine with a different byte order.");
+	}
+	if (header.version != SnapshotVersion) {
+		snapshot.close();
+		Error(filename + " is a version " + IntegerToString(header.version) + " snapshot, but only version "
+			  + IntegerToString(SnapshotVersion) + " can be read.");
+	}
+	if (header.numNodes < 0 || header.numArcs < 0 || header.nameBytes <= 0
+		|| snapshot.size() != SnapshotLayout(header.numNodes, header.numArcs, header.nameBytes).total) {
+		snapshot.close();
+		Error(filename + " is damaged: its size does not match its header.");
+	}
+	snapshotLayoutT layout = SnapshotLayout(header.numNodes, header.numArcs, header.nameBytes);
+	nameStarts = (const int *) (data + layout.nameStarts);
+	nameChars = data + layout.names;
+	locations = (const coordT *) (data + layout.locations);
+	arcs = (const edgeT *) (data + layout.arcs);
+	offsets = (const int *) (data + layout.offsets);
+	targets = (const int *) (data + layout.targets);
+	weights = (const double *) (data + layout.weights);
+	nodeCount = header.numNodes;
+	arcCount = header.numArcs;
+	if (offsets[nodeCount] != 2 * arcCount || nameStarts[nodeCount] >= header.nameBytes) {
+		clear();
+		Error(filename + " is damaged: its arrays do not match its header.");
+	}
+	pictureName = string(nameChars + nameStarts[nodeCount]);
+	namesIndexed = false;
+}
+
+bool Graph::IsSnapshotFile(string filename)
+{
+	ifstream in(filename.c_str(), ios::in | ios::binary);
+	char magic[sizeof SnapshotMagic];
+	in.read(magic, sizeof magic);
+	return !in.fail() && memcmp(magic, SnapshotMagic, sizeof magic) == 0;
+}
+
+void Graph::indexNames()
+{
+	nameToId.reserve(nodeCount);
+	nameToId.setNames(nameChars);
+	for (int i = 0; i < nodeCount; i++) {
+		nameToId.put(nameStarts[i], nameStarts[i + 1] - nameStarts[i] - 1, i);
+	}
+	namesIndexed = true;
+}
+
+/* Implementation notes: getDistanceScale
+ * ---------------------------------------
+ * If every arc is at least scale times as long as the straight line
+ * between its ends, then by the triangle inequality so is every path,
+ * and scale times the straight-line distance to a target drops by no
+ * more than an arc's length along any arc, which is what makes the
+ * A* estimate consistent. Arcs whose ends are at the same location
+ * put no limit on the scale. A graph with no such arcs gets a scale
+ * of 0, which is always safe.
+ */
+double Graph::getDistanceScale()
+{
+	if (distanceScale >= 0) return distanceScale;
+	double scale = -1;
+	for (int i = 0; i < arcCount; i++) {
+		coordT from = locations[arcs[i].from];
+		coordT to = locations[arcs[i].to];
+		double dx = to.x - from.x;
+		double dy = to.y - from.y;
+		double straight = sqrt(dx * dx + dy * dy);
+		if (straight == 0) continue;
+		double ratio = arcs[i].distance / straight;
+		if (scale < 0 || ratio < scale) scale = ratio;
+	}
+	distanceScale = (scale < 0) ? 0 : scale;
+	return distanceScale;
+}
+
+int Graph::findNode(const string & name)
+{
+	if (!namesIndexed) indexNames();
+	return nameToId.find(name);
+}
+
+string Graph::getName(int node)
+{
+	return string(nameChars + nameStarts[node], nameStarts[node + 1] - nameStarts[node] - 1);
+}
+
+coordT Graph::getLocation(int node)
+{
+	return locations[node];
+}
+
+cityT Graph::getCity(int node)
+{
+	cityT city;
+	city.location = locations[node];
+	city.id = node;
+	return city;
+}
+
+edgeT Graph::getArc(int arc)
+{
+	return arcs[arc];
+}
@@ -0,0 +1,290 @@
+/*
+ * File: graph.h
+ * -------------
+ * Defines the structures shared by the pathfinder modules and the
+ * Graph class, which stores the loaded graph in compressed sparse
+ * row (CSR) form so that the neighbors of a node can be visited in
+ * time proportional to its degree.
+ */
+
+#ifndef _graph_h
+#define _graph_h
+
+#include "genlib.h"
+#include "vector.h"
+#include "disallowcopy.h"
+#include "mappedfile.h"
+#include "nameindex.h"
+
+
+/* Type: coordT
+ * ------------
+ * Just a simple struct to handle a pair of x,y coordinate values.
+ */
+struct coordT {
+	double x, y;
+};
+
+/* Type: arcT
+ * ------------
+ * A struct to represent an edge between two nodes. Contains
+ * the id of each node, as given when the graph was loaded
+ * (Graph::getName turns one into the city's name), as well as
+ * the distance between them.
+ */
+struct arcT {
+	int city1;
+	int city2;
+	double distance;
+};
+
+/* Type: cityT
+ * ------------
+ * Represents a node on the graph as a city. Contains
+ * its location as a coordT and the integer id the city was
+ * given when the graph was loaded; Graph::getName gives its
+ * name. Two cities from the same graph are the same city
+ * exactly when their ids are equal.
+ */
+struct cityT {
+	coordT location;
+	int id;
+};
+
+/* Type: edgeT
+ * ------------
+ * An edge of the graph expressed in node ids rather than
+ * names. This is what the algorithms work with internally.
+ */
+struct edgeT {
+	int from;
+	int to;
+	double distance;
+};
+
+
+/*
+ * Constant: NoSuchNode
+ * --------------------
+ * The id returned by lookups that find no node.
+ */
+const int NoSuchNode = NameNotFound;
+
+
+/*
+ * Class: Graph
+ * ------------
+ * Nodes are numbered 0..numNodes()-1 in the order they are added.
+ * Arcs are undirected: each one is stored once in the arc list and
+ * twice (once per direction) in the adjacency arrays. The adjacency
+ * for node n occupies slots [firstSlot(n), endSlot(n)) of the
+ * parallel target/weight arrays.
+ *
+ * The graph is filled in one of two ways. Either addNode/addArc
+ * stage the data while a text file is being read and build() lays
+ * out the flat arrays, or loadSnapshot() maps a snapshot file written
+ * by saveSnapshot() and uses the arrays in it where they lie. The
+ * accessors below are only valid after build() or loadSnapshot().
+ */
+class Graph {
+  public:
+
+	Graph();
+	~Graph();
+
+	/*
+	 * Member function: clear
+	 * Usage: graph.clear();
+	 * ---------------------
+	 * Removes all nodes and arcs so that a new file can be loaded.
+	 */
+	void clear();
+
+	/*
+	 * Member function: addNode
+	 * Usage: id = graph.addNode(name, location);
+	 * ------------------------------------------
+	 * Adds a new node and returns the id assigned to it. A name may
+	 * be used by more than one node; findNode then finds the first.
+	 */
+	int addNode(string name, coordT location);
+
+	/*
+	 * Member function: addArc
+	 * Usage: graph.addArc(from, to, distance);
+	 * ----------------------------------------
+	 * Stages an undirected arc between two node ids.
+	 */
+	void addArc(int from, int to, double distance);
+
+	/*
+	 * Member function: build
+	 * Usage: graph.build();
+	 * ---------------------
+	 * Lays out the staged nodes and arcs as flat arrays: the names as
+	 * one string table, the locations, the arc list and the CSR
+	 * offsets + targets + weights. Runs in O(V + E) with a counting
+	 * pass and a fill pass. The staging storage is released.
+	 */
+	void build();
+
+	/*
+	 * Member functions: setPictureName, getPictureName
+	 * Usage: graph.setPictureName("USA.bmp");
+	 * ---------------------------------------
+	 * The background picture the graph is drawn over, kept with the
+	 * graph so that a snapshot can be drawn without its text file.
+	 */
+	void setPictureName(string name);
+	string getPictureName();
+
+	/*
+	 * Member function: saveSnapshot
+	 * Usage: graph.saveSnapshot("USA.graph");
+	 * ---------------------------------------
+	 * Writes the built graph to a binary snapshot file (the format is
+	 * described in graph.cpp). Raises an error if it cannot be written.
+	 */
+	void saveSnapshot(string filename);
+
+	/*
+	 * Member function: loadSnapshot
+	 * Usage: graph.loadSnapshot("USA.graph");
+	 * ---------------------------------------
+	 * Replaces the graph with the one in the snapshot file. The file is
+	 * memory-mapped and its arrays are used directly, so loading takes
+	 * time independent of the size of the graph. Raises an error if the
+	 * file is not a snapshot this version of the program can read.
+	 */
+	void loadSnapshot(string filename);
+
+	/*
+	 * Member function: IsSnapshotFile
+	 * Usage: if (Graph::IsSnapshotFile(filename)) . . .
+	 * -------------------------------------------------
+	 * Returns true if the file starts like a snapshot, which is how a
+	 * snapshot is told apart from a text graph file.
+	 */
+	static bool IsSnapshotFile(string filename);
+
+	/*
+	 * Member function: getDistanceScale
+	 * Usage: double scale = graph.getDistanceScale();
+	 * -----------------------------------------------
+	 * Returns the largest factor by which the straight-line distance
+	 * between the locations of two cities can be multiplied and still
+	 * be no more than the length of the shortest path between them:
+	 * the smallest ratio of an arc's length to the distance between
+	 * its ends. A* uses it to turn locations into distance estimates.
+	 * It is worked out in O(E) on the first call after a graph is
+	 * loaded, and remembered.
+	 */
+	double getDistanceScale();
+
+	/*
+	 * Member function: findNode
+	 * Usage: id = graph.findNode("Dallas");
+	 * -------------------------------------
+	 * Returns the id of the node with the given name, or NoSuchNode if
+	 * there is no such node; if several nodes have the name, the one
+	 * added first. The names are kept in a hash index over the graph's
+	 * own name table, so this takes O(1) expected time.
+	 */
+	int findNode(const string & name);
+
+	int numNodes();
+	int numArcs();
+
+	string getName(int node);
+	coordT getLocation(int node);
+
+	cityT getCity(int node);
+	edgeT getArc(int arc);
+
+	/*
+	 * Adjacency access
+	 * ----------------
+	 * The idiomatic loop over the neighbors of a node is:
+	 *
+	 *	for (int s = graph.firstSlot(n); s < graph.endSlot(n); s++) {
+	 *		int neighbor = graph.targetAt(s);
+	 *		double distance = graph.weightAt(s);
+	 *	}
+	 */
+	int firstSlot(int node);
+	int endSlot(int node);
+	int targetAt(int slot);
+	double weightAt(int slot);
+
+  private:
+	DISALLOW_COPYING(Graph)
+
+	/* Staging storage, only used between clear() and build(). */
+	string stagedNames;			// the names, each followed by a '\0'
+	Vector<int> stagedStarts;	// where each name starts in stagedNames
+	Vector<coordT> stagedLocations;
+	Vector<edgeT> stagedArcs;
+
+	NameIndex nameToId;
+	string pictureName;
+	int nodeCount;
+	int arcCount;
+
+	/*
+	 * The flat arrays. They point either at arrays allocated by build()
+	 * or into the mapped snapshot, which is open exactly when the
+	 * arrays are not owned.
+	 */
+	MappedFile snapshot;
+	const int *nameStarts;		// numNodes()+1 entries; name n is nameChars[nameStarts[n]..nameStarts[n+1]-1)
+	const char *nameChars;		// the names, each followed by a '\0'
+	const coordT *locations;	// numNodes() entries
+	const edgeT *arcs;			// numArcs() entries
+	const int *offsets;			// numNodes()+1 entries
+	const int *targets;			// 2*numArcs() entries
+	const double *weights;		// 2*numArcs() entries
+
+	bool namesIndexed;			// false until nameToId is filled in for a snapshot
+	double distanceScale;		// -1 until getDistanceScale works it out
+
+	void freeArrays();
+	void indexNames();
+};
+
+
+/*
+ * The adjacency accessors are called in the innermost loops of the
+ * searches, so they are defined inline and skip the range checks.
+ */
+
+inline int Graph::numNodes()
+{
+	return nodeCount;
+}
+
+inline int Graph::numArcs()
+{
+	return arcCount;
+}
+
+inline int Graph::firstSlot(int node)
+{
+	return offsets[node];
+}
+
+inline int Graph::endSlot(int node)
+{
+	return offsets[node + 1];
+}
+
+inline int Graph::targetAt(int slot)
+{
+	return targets[slot];
+}
+
+inline double Graph::weightAt(int slot)
+{
+	return weights[slot];
+}
+
+#endif
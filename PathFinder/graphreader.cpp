@@ -0,0 +1,205 @@
+/*
+ * File: graphreader.cpp
+ * ---------------------
+ * Implementation of the GraphReader class declared in graphreader.h.
+ */
+
+#include "graphreader.h"
+#include "strutils.h"
+#include <cstdlib>
+
+
+/* Powers of ten that a double holds exactly. */
+static const double ExactPowersOfTen[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+static const int MaxExactPower = 22;
+static const int MaxFastDigits = 19;
+static const unsigned long long MaxExactMantissa = 9007199254740992ULL;	// 2^53
+
+
+static bool IsSpace(char ch)
+{
+	return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t' || ch == '\f' || ch == '\v';
+}
+
+static bool IsDigit(char ch)
+{
+	return ch >= '0' && ch <= '9';
+}
+
+/* Function: SlowParseReal
+ * -----------------------
+ * The fallback for numbers the fast path cannot round exactly: copies
+ * the range so strtod sees a terminated string.
+ */
+static bool SlowParseReal(const char *start, const char *stop, double & value)
+{
+	string copy(start, stop - start);
+	char *parsedTo;
+	double result = strtod(copy.c_str(), &parsedTo);
+	if (parsedTo != copy.c_str() + copy.length()) return false;
+	value = result;
+	return true;
+}
+
+/* Implementation notes: ParseReal
+ * -------------------------------
+ * The digits before and after the decimal point are collected into one
+ * integer mantissa while counting how far the point has to move. If the
+ * mantissa fits in the 53 bits of a double and the power of ten is one
+ * a double holds exactly, a single multiply or divide is correctly
+ * rounded. Anything else is handed to strtod.
+ */
+bool ParseReal(const char *start, const char *stop, double & value)
+{
+	const char *p = start;
+	bool negative = false;
+	if (p < stop && (*p == '-' || *p == '+')) {
+		negative = (*p == '-');
+		p++;
+	}
+	unsigned long long mantissa = 0;
+	int numDigits = 0;				// significant digits in the mantissa
+	int exponent = 0;				// power of ten to apply to the mantissa
+	bool sawDigit = false;
+	bool exact = true;
+	for (; p < stop && IsDigit(*p); p++) {
+		sawDigit = true;
+		if (numDigits < MaxFastDigits) {
+			mantissa = mantissa * 10 + (*p - '0');
+			if (mantissa != 0) numDigits++;
+		} else {
+			exact = false;
+		}
+	}
+	if (p < stop && *p == '.') {
+		for (p++; p < stop && IsDigit(*p); p++) {
+			sawDigit = true;
+			if (numDigits < MaxFastDigits) {
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa != 0) numDigits++;
+				exponent--;
+			} else {
+				exact = false;
+			}
+		}
+	}
+	if (!sawDigit) return false;
+	if (p < stop && (*p == 'e' || *p == 'E')) {
+		p++;
+		bool negativeExponent = false;
+		if (p < stop && (*p == '-' || *p == '+')) {
+			negativeExponent = (*p == '-');
+			p++;
+		}
+		if (p == stop || !IsDigit(*p)) return false;
+		int written = 0;
+		for (; p < stop && IsDigit(*p); p++) {
+			if (written < 10000) written = written * 10 + (*p - '0');
+		}
+		exponent += negativeExponent ? -written : written;
+	}
+	if (p != stop) return false;
+	if (!exact || mantissa > MaxExactMantissa || exponent > MaxExactPower || exponent < -MaxExactPower) {
+		return SlowParseReal(start, stop, value);
+	}
+	double result = double(mantissa);
+	if (exponent < 0) {
+		result /= ExactPowersOfTen[-exponent];
+	} else {
+		result *= ExactPowersOfTen[exponent];
+	}
+	value = negative ? -result : result;
+	return true;
+}
+
+
+GraphReader::GraphReader()
+{
+	pos = end = NULL;
+	line = 1;
+}
+
+GraphReader::~GraphReader()
+{
+	close();
+}
+
+bool GraphReader::open(string filename)
+{
+	close();
+	if (!file.open(filename)) return false;
+	pos = file.data();
+	end = pos + file.size();
+	line = 1;
+	return true;
+}
+
+void GraphReader::close()
+{
+	file.close();
+	pos = end = NULL;
+}
+
+/* Private member function: nextToken
+ * ----------------------------------
+ * Skips whitespace, counting line endings as it goes ("\r\n" counts
+ * once), and sets [start, stop) to the next word. Returns false at
+ * the end of the file.
+ */
+bool GraphReader::nextToken(const char * & start, const char * & stop)
+{
+	while (pos < end && IsSpace(*pos)) {
+		if (*pos == '\n') {
+			line++;
+		} else if (*pos == '\r' && (pos + 1 == end || pos[1] != '\n')) {
+			line++;
+		}
+		pos++;
+	}
+	if (pos == end) return false;
+	start = pos;
+	while (pos < end && !IsSpace(*pos)) {
+		pos++;
+	}
+	stop = pos;
+	return true;
+}
+
+void GraphReader::tokenError(string expected, const char *start, const char *stop)
+{
+	if (start == NULL) {
+		Error("Expected " + expected + " on line " + IntegerToString(line) + " but the file ended");
+	}
+	Error("Expected " + expected + " on line " + IntegerToString(line) + " but found \"" +
+		  string(start, stop - start) + "\"");
+}
+
+bool GraphReader::readWord(string & word)
+{
+	const char *start, *stop;
+	if (!nextToken(start, stop)) return false;
+	word.assign(start, stop - start);
+	return true;
+}
+
+double GraphReader::readReal()
+{
+	const char *start = NULL, *stop = NULL;
+	double value;
+	if (!nextToken(start, stop)) tokenError("a number", NULL, NULL);
+	if (!ParseReal(start, stop, value)) tokenError("a number", start, stop);
+	return value;
+}
+
+int GraphReader::lineNumber()
+{
+	return line;
+}
+
+double GraphReader::fileSize()
+{
+	return double(file.size());
+}
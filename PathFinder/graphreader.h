@@ -0,0 +1,111 @@
+/*
+ * File: graphreader.h
+ * -------------------
+ * A fast reader for the whitespace-separated text files the program
+ * loads (the NODES/ARCS graph files and the query files). The whole
+ * file is mapped into memory (see mappedfile.h) and split into words
+ * in place, so reading a number never allocates and reading a word
+ * only copies it into the caller's string.
+ */
+
+#ifndef _graphreader_h
+#define _graphreader_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "mappedfile.h"
+
+
+/*
+ * Class: GraphReader
+ * ------------------
+ * Reads a file one word at a time. Words are separated by spaces,
+ * tabs and any style of line ending ("\n", "\r\n" or the old Mac
+ * "\r"). Numbers may be negative, may have a fractional part and may
+ * use an exponent, e.g. "-12", "0.048" or "1.5e3".
+ */
+class GraphReader {
+  public:
+
+	GraphReader();
+	~GraphReader();
+
+	/*
+	 * Member function: open
+	 * Usage: if (reader.open(filename)) . . .
+	 * ---------------------------------------
+	 * Opens the file for reading, closing any file that was already
+	 * open. Returns false if the file cannot be opened.
+	 */
+	bool open(string filename);
+
+	/*
+	 * Member function: close
+	 * Usage: reader.close();
+	 * ----------------------
+	 * Releases the file. Also done by the destructor.
+	 */
+	void close();
+
+	/*
+	 * Member function: readWord
+	 * Usage: while (reader.readWord(word)) . . .
+	 * ------------------------------------------
+	 * Stores the next word in word and returns true, or returns false
+	 * at the end of the file. The string's storage is reused, so
+	 * reading into the same string over and over does not allocate.
+	 */
+	bool readWord(string & word);
+
+	/*
+	 * Member function: readReal
+	 * Usage: double x = reader.readReal();
+	 * ------------------------------------
+	 * Reads the next word as a real number. Raises an error, naming
+	 * the line, if the file has ended or the word is not a number.
+	 */
+	double readReal();
+
+	/*
+	 * Member function: lineNumber
+	 * Usage: cout << "on line " << reader.lineNumber();
+	 * -------------------------------------------------
+	 * Returns the line of the word most recently read, counting from 1.
+	 */
+	int lineNumber();
+
+	/*
+	 * Member function: fileSize
+	 * Usage: bytes = reader.fileSize();
+	 * ---------------------------------
+	 * Returns the size of the open file in bytes.
+	 */
+	double fileSize();
+
+  private:
+	DISALLOW_COPYING(GraphReader)
+
+	MappedFile file;
+	const char *pos;		// next character to look at
+	const char *end;		// one past the last character
+	int line;
+
+	bool nextToken(const char * & start, const char * & stop);
+	void tokenError(string expected, const char *start, const char *stop);
+};
+
+
+/*
+ * Function: ParseReal
+ * Usage: if (ParseReal(start, stop, value)) . . .
+ * -----------------------------------------------
+ * Converts the characters [start, stop) to a double without copying
+ * them. Returns false, leaving value unchanged, unless the whole range
+ * is a number. Up to 19 significant digits are read into an integer
+ * and scaled by one exact power of ten, which gives the correctly
+ * rounded result for all the numbers the graph files contain; longer
+ * or more extreme numbers fall back to strtod.
+ */
+bool ParseReal(const char *start, const char *stop, double & value);
+
+#endif
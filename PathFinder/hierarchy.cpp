@@ -0,0 +1,562 @@
+/*
+ * File: hierarchy.cpp
+ * -------------------
+ * Implementation of the ContractionHierarchy class declared in
+ * hierarchy.h.
+ */
+
+#include "hierarchy.h"
+#include "landmarks.h"
+#include "pqueue.h"
+#include "vector.h"
+#include <cstdlib> // for NULL
+#include <cstring>
+#include <fstream>
+
+
+/* Hierarchy file format
+ * ---------------------
+ * A hierarchyHeaderT, then int rank[numNodes], int upOffsets[numNodes+1],
+ * int upTargets[numUpEdges] and int upMiddles[numUpEdges], padded to a
+ * multiple of 8 bytes, then double upWeights[numUpEdges]. As with graph
+ * snapshots, the byte order mark rejects a file from a machine of the
+ * other byte order, and any change to the layout must bump
+ * HierarchyVersion.
+ */
+
+static const char HierarchyMagic[8] = "PFCHIER";
+static const int HierarchyVersion = 1;
+static const int HierarchyByteOrder = 0x01020304;
+
+struct hierarchyHeaderT {
+	char magic[8];
+	int version;
+	int byteOrder;
+	int numNodes;
+	int numArcs;
+	int numUpEdges;
+	unsigned fingerprint;
+};
+
+/* Returns the number of zero bytes between upMiddles and upWeights. */
+static size_t WeightsPadding(int numNodes, int numUpEdges)
+{
+	size_t position = sizeof(hierarchyHeaderT)
+		+ (2 * size_t(numNodes) + 1 + 2 * size_t(numUpEdges)) * sizeof(int);
+	return (8 - position % 8) % 8;
+}
+
+
+/*
+ * Constant: MaxWitnessSettled
+ * ---------------------------
+ * The number of cities a witness search may settle before it gives
+ * up. Giving up early only costs a shortcut that was not needed, so
+ * this trades preprocessing time against the size of the hierarchy.
+ */
+static const int MaxWitnessSettled = 500;
+
+
+/* Type: chArcT
+ * ------------
+ * An arc or shortcut while the hierarchy is being built. middle is
+ * the city a shortcut bypasses, or -1 for an arc of the graph.
+ */
+struct chArcT {
+	int target;
+	double weight;
+	int middle;
+};
+
+/* Type: contractionT
+ * ------------------
+ * The state of the contraction. adjacent[v] holds v's arcs to the
+ * cities that are not contracted yet; once v itself is contracted it
+ * is never changed again and is v's list of upward edges. The
+ * witness search keeps its distances between calls and resets only
+ * the cities it touched.
+ */
+struct contractionT {
+	Vector<chArcT> *adjacent;
+	int *contractedNeighbors;
+	double *witnessDistance;	// NoDistance for cities the last witness search did not reach
+	bool *isWitnessTarget;		// the cities the current witness search is looking for
+	Vector<int> touched;
+	IndexedPQueue<double> *witnessPQ;
+};
+
+
+/* Function: FindArc
+ * -----------------
+ * Returns the index of the arc to target in the list, or -1.
+ */
+static int FindArc(Vector<chArcT> & arcs, int target)
+{
+	for (int i = 0; i < arcs.size(); i++) {
+		if (arcs[i].target == target) return i;
+	}
+	return -1;
+}
+
+/* Function: AddOrLowerArc
+ * -----------------------
+ * Adds an arc to the list, or shortens the one already there to the
+ * same target if the new one is shorter. Returns true if the list
+ * gained an arc.
+ */
+static bool AddOrLowerArc(Vector<chArcT> & arcs, int target, double weight, int middle)
+{
+	int index = FindArc(arcs, target);
+	if (index == -1) {
+		chArcT arc;
+		arc.target = target;
+		arc.weight = weight;
+		arc.middle = middle;
+		arcs.add(arc);
+		return true;
+	}
+	if (weight < arcs[index].weight) {
+		arcs[index].weight = weight;
+		arcs[index].middle = middle;
+	}
+	return false;
+}
+
+/* Function: WitnessSearch
+ * -----------------------
+ * Runs Dijkstra's algorithm from source over the cities that are not
+ * contracted yet, leaving out skip, until the next distance would
+ * exceed limit, all numTargets cities marked in isWitnessTarget are
+ * settled or MaxWitnessSettled cities are settled. Afterwards
+ * witnessDistance[w] is the length of some path from source to w that
+ * avoids skip, or NoDistance if none was found; it need not be the
+ * shortest one, but it is a real path, which is all a witness needs.
+ */
+static void WitnessSearch(contractionT & state, int source, int skip, double limit, int numTargets)
+{
+	for (int i = 0; i < state.touched.size(); i++) {
+		state.witnessDistance[state.touched[i]] = NoDistance;
+	}
+	state.touched.clear();
+	state.witnessPQ->clear();
+
+	state.witnessDistance[source] = 0;
+	state.touched.add(source);
+	state.witnessPQ->enqueue(source, 0);
+	for (int settled = 0; settled < MaxWitnessSettled && !state.witnessPQ->isEmpty(); settled++) {
+		int city = state.witnessPQ->dequeueMin();
+		double distance = state.witnessDistance[city];
+		if (distance > limit) break;
+		if (state.isWitnessTarget[city] && --numTargets == 0) break;
+		Vector<chArcT> & arcs = state.adjacent[city];
+		for (int i = 0; i < arcs.size(); i++) {
+			int neighbor = arcs[i].target;
+			if (neighbor == skip) continue;
+			double newDistance = distance + arcs[i].weight;
+			if (newDistance >= state.witnessDistance[neighbor]) continue;
+			if (state.witnessDistance[neighbor] == NoDistance) {
+				state.touched.add(neighbor);
+				state.witnessPQ->enqueue(neighbor, newDistance);
+			} else if (state.witnessPQ->contains(neighbor)) {
+				state.witnessPQ->decreaseKey(neighbor, newDistance);
+			}
+			state.witnessDistance[neighbor] = newDistance;
+		}
+	}
+}
+
+/* Function: ContractNode
+ * ----------------------
+ * Works out which shortcuts contracting city v needs: for each pair
+ * of its neighbors u, w, one as long as u-v-w unless the witness
+ * search from u finds a path to w that avoids v and is no longer.
+ * Returns how many there are and, unless simulate is true, adds them.
+ * Each pair is looked at once, from the neighbor earlier in the list.
+ */
+static int ContractNode(contractionT & state, int v, bool simulate)
+{
+	Vector<chArcT> & arcs = state.adjacent[v];
+	int shortcuts = 0;
+	for (int i = 0; i + 1 < arcs.size(); i++) {
+		int from = arcs[i].target;
+		double longest = 0;
+		for (int j = i + 1; j < arcs.size(); j++) {
+			if (arcs[j].weight > longest) longest = arcs[j].weight;
+			state.isWitnessTarget[arcs[j].target] = true;
+		}
+		WitnessSearch(state, from, v, arcs[i].weight + longest, arcs.size() - i - 1);
+		for (int j = i + 1; j < arcs.size(); j++) {
+			int to = arcs[j].target;
+			state.isWitnessTarget[to] = false;
+			double via = arcs[i].weight + arcs[j].weight;
+			if (state.witnessDistance[to] <= via) continue;
+			shortcuts++;
+			if (!simulate) {
+				AddOrLowerArc(state.adjacent[from], to, via, v);
+				AddOrLowerArc(state.adjacent[to], from, via, v);
+			}
+		}
+	}
+	return shortcuts;
+}
+
+/* Function: Priority
+ * ------------------
+ * The contraction priority of city v, smallest first: twice its edge
+ * difference (the shortcuts contracting it would add less the arcs it
+ * would remove) plus the number of its neighbors already contracted,
+ * which spreads the contraction evenly over the graph.
+ */
+static int Priority(contractionT & state, int v)
+{
+	int shortcuts = ContractNode(state, v, true);
+	return 2 * (shortcuts - state.adjacent[v].size()) + state.contractedNeighbors[v];
+}
+
+
+ContractionHierarchy::ContractionHierarchy()
+{
+	numNodes = 0;
+	numArcs = 0;
+	fingerprint = 0;
+	numUpEdges = 0;
+	rank = NULL;
+	upOffsets = NULL;
+	upTargets = NULL;
+	upWeights = NULL;
+	upMiddles = NULL;
+}
+
+ContractionHierarchy::~ContractionHierarchy()
+{
+	clear();
+}
+
+void ContractionHierarchy::clear()
+{
+	delete[] rank;
+	delete[] upOffsets;
+	delete[] upTargets;
+	delete[] upWeights;
+	delete[] upMiddles;
+	rank = NULL;
+	upOffsets = NULL;
+	upTargets = NULL;
+	upWeights = NULL;
+	upMiddles = NULL;
+	numNodes = 0;
+	numArcs = 0;
+	fingerprint = 0;
+	numUpEdges = 0;
+}
+
+void ContractionHierarchy::allocate(int nodes, int upEdges)
+{
+	numNodes = nodes;
+	numUpEdges = upEdges;
+	rank = new int[nodes];
+	upOffsets = new int[nodes + 1];
+	upTargets = new int[upEdges];
+	upWeights = new double[upEdges];
+	upMiddles = new int[upEdges];
+}
+
+/* Implementation notes: build
+ * ---------------------------
+ * The priorities are kept in an IndexedPQueue and updated lazily: the
+ * city at the front has its priority worked out again before it is
+ * contracted, and goes back into the queue if it is no longer the
+ * smallest. After a contraction only the neighbors of the contracted
+ * city can have changed, so only theirs are updated. Parallel arcs
+ * are merged into the shortest one and loops are dropped, since
+ * neither is ever on a shortest path.
+ */
+void ContractionHierarchy::build(Graph & graph)
+{
+	clear();
+	int nodes = graph.numNodes();
+	contractionT state;
+	state.adjacent = new Vector<chArcT>[nodes];
+	state.contractedNeighbors = new int[nodes];
+	state.witnessDistance = new double[nodes];
+	state.isWitnessTarget = new bool[nodes];
+	state.witnessPQ = new IndexedPQueue<double>(nodes);
+	for (int v = 0; v < nodes; v++) {
+		state.contractedNeighbors[v] = 0;
+		state.witnessDistance[v] = NoDistance;
+		state.isWitnessTarget[v] = false;
+		for (int slot = graph.firstSlot(v); slot < graph.endSlot(v); slot++) {
+			if (graph.targetAt(slot) != v) AddOrLowerArc(state.adjacent[v], graph.targetAt(slot), graph.weightAt(slot), -1);
+		}
+	}
+
+	int *order = new int[nodes];
+	IndexedPQueue<int> pq(nodes);
+	for (int v = 0; v < nodes; v++) {
+		pq.enqueue(v, Priority(state, v));
+	}
+	int contracted = 0;
+	while (!pq.isEmpty()) {
+		int v = pq.peekMin();
+		int priority = Priority(state, v);
+		if (priority != pq.getKey(v)) {
+			pq.changeKey(v, priority);
+			if (pq.peekMin() != v) continue;
+		}
+		pq.dequeueMin();
+		ContractNode(state, v, false);
+		order[contracted++] = v;
+		Vector<chArcT> & arcs = state.adjacent[v];
+		for (int i = 0; i < arcs.size(); i++) {
+			Vector<chArcT> & back = state.adjacent[arcs[i].target];
+			int index = FindArc(back, v);
+			back[index] = back[back.size() - 1];
+			back.removeAt(back.size() - 1);
+			state.contractedNeighbors[arcs[i].target]++;
+		}
+		for (int i = 0; i < arcs.size(); i++) {
+			pq.changeKey(arcs[i].target, Priority(state, arcs[i].target));
+		}
+	}
+
+	int upEdges = 0;
+	for (int v = 0; v < nodes; v++) {
+		upEdges += state.adjacent[v].size();
+	}
+	allocate(nodes, upEdges);
+	numArcs = graph.numArcs();
+	fingerprint = GraphFingerprint(graph);
+	for (int i = 0; i < nodes; i++) {
+		rank[order[i]] = i;
+	}
+	int slot = 0;
+	for (int v = 0; v < nodes; v++) {
+		upOffsets[v] = slot;
+		Vector<chArcT> & arcs = state.adjacent[v];
+		for (int i = 0; i < arcs.size(); i++, slot++) {
+			upTargets[slot] = arcs[i].target;
+			upWeights[slot] = arcs[i].weight;
+			upMiddles[slot] = arcs[i].middle;
+		}
+	}
+	upOffsets[nodes] = slot;
+
+	delete[] order;
+	delete[] state.adjacent;
+	delete[] state.contractedNeighbors;
+	delete[] state.witnessDistance;
+	delete[] state.isWitnessTarget;
+	delete state.witnessPQ;
+}
+
+int ContractionHierarchy::numShortcuts()
+{
+	int shortcuts = 0;
+	for (int slot = 0; slot < numUpEdges; slot++) {
+		if (upMiddles[slot] != -1) shortcuts++;
+	}
+	return shortcuts;
+}
+
+void ContractionHierarchy::save(string filename)
+{
+	hierarchyHeaderT header;
+	memset(&header, 0, sizeof header);
+	memcpy(header.magic, HierarchyMagic, sizeof header.magic);
+	header.version = HierarchyVersion;
+	header.byteOrder = HierarchyByteOrder;
+	header.numNodes = numNodes;
+	header.numArcs = numArcs;
+	header.numUpEdges = numUpEdges;
+	header.fingerprint = fingerprint;
+
+	ofstream out(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if (out.fail()) Error("Cannot write the contraction hierarchy " + filename);
+	static const char zeros[8] = { 0 };
+	out.write((const char *) &header, sizeof header);
+	out.write((const char *) rank, numNodes * sizeof(int));
+	out.write((const char *) upOffsets, (numNodes + 1) * sizeof(int));
+	out.write((const char *) upTargets, numUpEdges * sizeof(int));
+	out.write((const char *) upMiddles, numUpEdges * sizeof(int));
+	out.write(zeros, WeightsPadding(numNodes, numUpEdges));
+	out.write((const char *) upWeights, numUpEdges * sizeof(double));
+	out.close();
+	if (out.fail()) Error("Cannot write the contraction hierarchy " + filename);
+}
+
+/* Implementation notes: load
+ * --------------------------
+ * Besides the header, the offsets and the city ids in the file are
+ * checked, so that a damaged file is turned away here rather than
+ * sending a query outside the arrays.
+ */
+bool ContractionHierarchy::load(string filename, Graph & graph)
+{
+	clear();
+	ifstream in(filename.c_str(), ios::in | ios::binary);
+	if (in.fail()) return false;
+	hierarchyHeaderT header;
+	in.read((char *) &header, sizeof header);
+	if (in.fail() || memcmp(header.magic, HierarchyMagic, sizeof header.magic) != 0
+		|| header.version != HierarchyVersion || header.byteOrder != HierarchyByteOrder
+		|| header.numNodes != graph.numNodes() || header.numArcs != graph.numArcs()
+		|| header.numUpEdges < 0 || header.fingerprint != GraphFingerprint(graph)) {
+		return false;
+	}
+	allocate(header.numNodes, header.numUpEdges);
+	in.read((char *) rank, numNodes * sizeof(int));
+	in.read((char *) upOffsets, (numNodes + 1) * sizeof(int));
+	in.read((char *) upTargets, numUpEdges * sizeof(int));
+	in.read((char *) upMiddles, numUpEdges * sizeof(int));
+	in.ignore(WeightsPadding(numNodes, numUpEdges));
+	in.read((char *) upWeights, numUpEdges * sizeof(double));
+	bool valid = !in.fail() && upOffsets[0] == 0 && upOffsets[numNodes] == numUpEdges;
+	for (int v = 0; valid && v < numNodes; v++) {
+		valid = upOffsets[v] <= upOffsets[v + 1] && rank[v] >= 0 && rank[v] < numNodes;
+	}
+	for (int slot = 0; valid && slot < numUpEdges; slot++) {
+		valid = upTargets[slot] >= 0 && upTargets[slot] < numNodes
+			&& upMiddles[slot] >= -1 && upMiddles[slot] < numNodes;
+	}
+	if (!valid) {
+		clear();
+		return false;
+	}
+	numArcs = header.numArcs;
+	fingerprint = header.fingerprint;
+	return true;
+}
+
+bool ContractionHierarchy::isBuiltFor(Graph & graph)
+{
+	return rank != NULL && numNodes == graph.numNodes() && numArcs == graph.numArcs()
+		&& fingerprint == GraphFingerprint(graph);
+}
+
+
+/* Function: ExpandUpward
+ * ----------------------
+ * Settles the next city of one side and relaxes its upward edges,
+ * updating best and meeting like ExpandSide in search.cpp whenever a
+ * city reached by both sides gets a shorter path through it. The
+ * parentSlot of a city is the upward edge it was reached by, which
+ * belongs to its parent since the parent has the lower rank.
+ */
+static void ExpandUpward(const int *offsets, const int *targets, const double *weights,
+						 searchSideT & side, searchSideT & other, double & best, int & meeting)
+{
+	int city = side.pq->dequeueMin();
+	for (int slot = offsets[city]; slot < offsets[city + 1]; slot++) {
+		int neighbor = targets[slot];
+		double newDistance = side.distance[city] + weights[slot];
+		if (side.isReached(neighbor) && newDistance >= side.distance[neighbor]) continue;
+		side.distance[neighbor] = newDistance;
+		side.parent[neighbor] = city;
+		side.markReached(neighbor);
+		side.parentSlot[neighbor] = slot;
+		if (side.pq->contains(neighbor)) {
+			side.pq->decreaseKey(neighbor, newDistance);
+		} else {
+			side.pq->enqueue(neighbor, newDistance);
+		}
+		if (other.isReached(neighbor) && (meeting == -1 || newDistance + other.distance[neighbor] < best)) {
+			best = newDistance + other.distance[neighbor];
+			meeting = neighbor;
+		}
+	}
+}
+
+int ContractionHierarchy::findUpSlot(int node, int neighbor)
+{
+	for (int slot = upOffsets[node]; slot < upOffsets[node + 1]; slot++) {
+		if (upTargets[slot] == neighbor) return slot;
+	}
+	Error("The contraction hierarchy is missing an edge a shortcut goes through");
+	return -1;
+}
+
+/* Implementation notes: unpackEdge
+ * --------------------------------
+ * Appends the cities after from along the edge in the given slot, up
+ * to and including to. A shortcut from-to bypassing m was made out of
+ * the edges m-from and m-to, which were m's upward edges when m was
+ * contracted, so both are found in m's list and unpacked in turn.
+ */
+void ContractionHierarchy::unpackEdge(int from, int to, int slot, Vector<int> & nodes)
+{
+	int middle = upMiddles[slot];
+	if (middle == -1) {
+		nodes.add(to);
+		return;
+	}
+	unpackEdge(from, middle, findUpSlot(middle, from), nodes);
+	unpackEdge(middle, to, findUpSlot(middle, to), nodes);
+}
+
+/* Implementation notes: query
+ * ---------------------------
+ * Both searches only follow upward edges and so never meet in the
+ * middle the way bidirectional Dijkstra's do: the first city reached
+ * by both is usually not on the shortest path. Instead each side runs
+ * until its smallest key is at least the best path found, after which
+ * nothing it settles can improve on it.
+ */
+void ContractionHierarchy::query(int source, int target, searchResultT & result, SearchWorkspace *workspace)
+{
+	result.found = false;
+	result.distance = 0;
+	result.nodes.clear();
+	result.expanded = 0;
+	if (source == target) {
+		result.found = true;
+		result.nodes.add(source);
+		return;
+	}
+
+	SearchWorkspace scratch;
+	if (workspace == NULL) workspace = &scratch;
+	workspace->prepare(numNodes);
+	searchSideT & forward = workspace->forward();
+	searchSideT & backward = workspace->backward();
+	forward.distance[source] = 0;
+	forward.parent[source] = source;
+	forward.markReached(source);
+	forward.pq->enqueue(source, 0);
+	backward.distance[target] = 0;
+	backward.parent[target] = target;
+	backward.markReached(target);
+	backward.pq->enqueue(target, 0);
+
+	double best = NoDistance;
+	int meeting = -1;
+	while (true) {
+		bool forwardDone = forward.pq->isEmpty() || forward.pq->getKey(forward.pq->peekMin()) >= best;
+		bool backwardDone = backward.pq->isEmpty() || backward.pq->getKey(backward.pq->peekMin()) >= best;
+		if (forwardDone && backwardDone) break;
+		if (backwardDone || (!forwardDone && forward.pq->getKey(forward.pq->peekMin())
+										   <= backward.pq->getKey(backward.pq->peekMin()))) {
+			ExpandUpward(upOffsets, upTargets, upWeights, forward, backward, best, meeting);
+		} else {
+			ExpandUpward(upOffsets, upTargets, upWeights, backward, forward, best, meeting);
+		}
+		result.expanded++;
+	}
+
+	if (meeting != -1) {
+		result.found = true;
+		result.distance = best;
+		Vector<int> climb;					//source to meeting, in the hierarchy
+		for (int city = meeting; city != source; city = forward.parent[city]) {
+			climb.add(city);
+		}
+		result.nodes.add(source);
+		int from = source;
+		for (int i = climb.size() - 1; i >= 0; i--) {
+			unpackEdge(from, climb[i], forward.parentSlot[climb[i]], result.nodes);
+			from = climb[i];
+		}
+		for (int city = meeting; city != target; city = backward.parent[city]) {
+			unpackEdge(city, backward.parent[city], backward.parentSlot[city], result.nodes);
+		}
+	}
+}
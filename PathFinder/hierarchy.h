@@ -0,0 +1,139 @@
+/*
+ * File: hierarchy.h
+ * -----------------
+ * Contraction hierarchies. Preprocessing puts the cities in order of
+ * importance and removes ("contracts") them one at a time, least
+ * important first. Whenever removing a city v would lengthen the
+ * shortest path between two of its remaining neighbors u and w, a
+ * shortcut u-w as long as u-v-w is added in its place. Every shortest
+ * path then has a counterpart that first climbs to more important
+ * cities and then descends, so a query only has to search upwards
+ * from both ends. On a road network the upward searches settle a few
+ * hundred cities where Dijkstra's algorithm settles most of the map.
+ */
+
+#ifndef _hierarchy_h
+#define _hierarchy_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "graph.h"
+#include "search.h"
+
+
+/*
+ * Class: ContractionHierarchy
+ * ---------------------------
+ * The contraction order and the upward graph for one graph. The
+ * upward graph holds, for every city, the arcs and shortcuts to the
+ * cities contracted after it, in CSR form like Graph. A shortcut
+ * remembers the city it bypasses so that a path through it can be
+ * unpacked back into arcs of the original graph.
+ */
+class ContractionHierarchy {
+  public:
+
+	ContractionHierarchy();
+	~ContractionHierarchy();
+
+	/*
+	 * Member function: build
+	 * Usage: hierarchy.build(graph);
+	 * ------------------------------
+	 * Contracts every city of the graph. The next city contracted is
+	 * always the one with the smallest edge difference (the shortcuts
+	 * contracting it would add minus the arcs it would remove), counted
+	 * twice, plus the number of its neighbors already contracted,
+	 * which keeps the contraction spread evenly over the map. A
+	 * shortcut is only added if a short local search (the witness
+	 * search) finds no other path between its ends that is as short.
+	 */
+	void build(Graph & graph);
+
+	/*
+	 * Member function: clear
+	 * Usage: hierarchy.clear();
+	 * -------------------------
+	 * Forgets the hierarchy, e.g. because another graph was loaded.
+	 */
+	void clear();
+
+	/*
+	 * Member function: save
+	 * Usage: hierarchy.save("USA.ch");
+	 * --------------------------------
+	 * Writes the hierarchy to a binary file, together with a
+	 * fingerprint of the graph it was built for. Raises an error if
+	 * the file cannot be written.
+	 */
+	void save(string filename);
+
+	/*
+	 * Member function: load
+	 * Usage: if (hierarchy.load("USA.ch", graph)) . . .
+	 * -------------------------------------------------
+	 * Reads a hierarchy written by save. Returns false, leaving the
+	 * hierarchy empty, if the file does not exist, is not a hierarchy
+	 * file this version can read, or was built for a different graph.
+	 */
+	bool load(string filename, Graph & graph);
+
+	/*
+	 * Member function: isBuiltFor
+	 * Usage: if (!hierarchy.isBuiltFor(graph)) . . .
+	 * ----------------------------------------------
+	 * Returns true if the hierarchy was built (or loaded) for a graph
+	 * with the same fingerprint as this one.
+	 */
+	bool isBuiltFor(Graph & graph);
+
+	/*
+	 * Member function: query
+	 * Usage: hierarchy.query(source, target, result);
+	 * -----------------------------------------------
+	 * Finds a shortest path from source to target and stores it in
+	 * result as the other searches do. The shortcuts on the path are
+	 * unpacked, so result.nodes lists cities joined by original arcs.
+	 * expanded counts the cities settled by both upward searches.
+	 * The searches run in the workspace if one is given. Queries
+	 * only read the hierarchy, so several threads can run them at
+	 * once, each with its own workspace.
+	 */
+	void query(int source, int target, searchResultT & result, SearchWorkspace *workspace = NULL);
+
+	/*
+	 * Member functions: size, numShortcuts
+	 * Usage: cout << hierarchy.numShortcuts() << " shortcuts";
+	 * --------------------------------------------------------
+	 * size returns the number of cities in the hierarchy, which is 0
+	 * if it is empty, and numShortcuts the number of shortcuts that
+	 * preprocessing added.
+	 */
+	int size();
+	int numShortcuts();
+
+  private:
+	DISALLOW_COPYING(ContractionHierarchy)
+
+	int numNodes;
+	int numArcs;
+	unsigned fingerprint;
+	int numUpEdges;
+	int *rank;					// position of each city in the contraction order
+	int *upOffsets;				// numNodes+1 entries; city v's upward edges are slots [upOffsets[v], upOffsets[v+1])
+	int *upTargets;				// numUpEdges entries, each of higher rank than the city it belongs to
+	double *upWeights;			// numUpEdges entries
+	int *upMiddles;				// numUpEdges entries; the city a shortcut bypasses, -1 for an original arc
+
+	void allocate(int nodes, int upEdges);
+	int findUpSlot(int node, int neighbor);
+	void unpackEdge(int from, int to, int slot, Vector<int> & nodes);
+};
+
+
+inline int ContractionHierarchy::size()
+{
+	return numNodes;
+}
+
+#endif
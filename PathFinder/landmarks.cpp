@@ -0,0 +1,246 @@
+/*
+ * File: landmarks.cpp
+ * -------------------
+ * Implementation of the Landmarks class declared in landmarks.h.
+ */
+
+#include "landmarks.h"
+#include <cstdlib> // for NULL
+#include <cstring>
+#include <fstream>
+
+
+/* Landmark file format
+ * --------------------
+ * A landmarkHeaderT, then int landmarks[count] padded to a multiple
+ * of 8 bytes, then double table[numNodes * count] in the same order
+ * as in memory. As with graph snapshots, the byte order mark rejects
+ * a file from a machine of the other byte order, and any change to
+ * the layout must bump LandmarkVersion.
+ */
+
+static const char LandmarkMagic[8] = "PFLMARK";
+static const int LandmarkVersion = 1;
+static const int LandmarkByteOrder = 0x01020304;
+
+struct landmarkHeaderT {
+	char magic[8];
+	int version;
+	int byteOrder;
+	int numNodes;
+	int numArcs;
+	int count;
+	unsigned fingerprint;
+};
+
+
+/* Implementation notes: GraphFingerprint
+ * --------------------------------------
+ * FNV-1a over the ends and length of every arc, taken field by field
+ * so that padding inside edgeT cannot affect it.
+ */
+unsigned GraphFingerprint(Graph & graph)
+{
+	unsigned hash = 2166136261u;
+	for (int i = 0; i < graph.numArcs(); i++) {
+		edgeT arc = graph.getArc(i);
+		unsigned char bytes[sizeof(int) * 2 + sizeof(double)];
+		memcpy(bytes, &arc.from, sizeof(int));
+		memcpy(bytes + sizeof(int), &arc.to, sizeof(int));
+		memcpy(bytes + 2 * sizeof(int), &arc.distance, sizeof(double));
+		for (size_t b = 0; b < sizeof bytes; b++) {
+			hash ^= bytes[b];
+			hash *= 16777619u;
+		}
+	}
+	return hash;
+}
+
+
+Landmarks::Landmarks()
+{
+	count = 0;
+	numNodes = 0;
+	numArcs = 0;
+	fingerprint = 0;
+	landmarks = NULL;
+	table = NULL;
+}
+
+Landmarks::~Landmarks()
+{
+	clear();
+}
+
+void Landmarks::clear()
+{
+	delete[] landmarks;
+	delete[] table;
+	landmarks = NULL;
+	table = NULL;
+	count = 0;
+	numNodes = 0;
+	numArcs = 0;
+	fingerprint = 0;
+}
+
+/* Implementation notes: build
+ * ---------------------------
+ * closest[v] is the distance from v to the nearest landmark picked so
+ * far, NoDistance while no landmark reaches v. Each new landmark is
+ * the city with the largest closest[], lowest id first on ties, and
+ * the search from it both fills its column of the table and lowers
+ * closest[]. Picking again a city that is already a landmark adds
+ * nothing, which only happens once closest[] is 0 everywhere, i.e.
+ * when there are more landmarks than cities.
+ */
+void Landmarks::build(Graph & graph, int numLandmarks)
+{
+	clear();
+	numNodes = graph.numNodes();
+	numArcs = graph.numArcs();
+	fingerprint = GraphFingerprint(graph);
+	if (numLandmarks > numNodes) numLandmarks = numNodes;
+	if (numLandmarks <= 0) return;
+	landmarks = new int[numLandmarks];
+	table = new double[size_t(numNodes) * numLandmarks];
+	double *distance = new double[numNodes];
+	double *closest = new double[numNodes];
+	SearchWorkspace workspace;
+
+	ShortestPathTree(graph, 0, closest, NULL, &workspace);
+	for (int v = 0; v < numNodes; v++) {
+		if (closest[v] == NoDistance) closest[v] = 0;	//city 0 only seeds the search within its own piece
+	}
+	for (int i = 0; i < numLandmarks; i++) {
+		int farthest = 0;
+		for (int v = 1; v < numNodes; v++) {
+			if (closest[v] > closest[farthest]) farthest = v;
+		}
+		if (i == 0) {
+			for (int v = 0; v < numNodes; v++) {
+				closest[v] = NoDistance;
+			}
+		}
+		landmarks[i] = farthest;
+		ShortestPathTree(graph, farthest, distance, NULL, &workspace);
+		for (int v = 0; v < numNodes; v++) {
+			table[size_t(v) * numLandmarks + i] = distance[v];
+			if (distance[v] < closest[v]) closest[v] = distance[v];
+		}
+		count = i + 1;
+	}
+	delete[] distance;
+	delete[] closest;
+}
+
+void Landmarks::save(string filename)
+{
+	landmarkHeaderT header;
+	memset(&header, 0, sizeof header);
+	memcpy(header.magic, LandmarkMagic, sizeof header.magic);
+	header.version = LandmarkVersion;
+	header.byteOrder = LandmarkByteOrder;
+	header.numNodes = numNodes;
+	header.numArcs = numArcs;
+	header.count = count;
+	header.fingerprint = fingerprint;
+
+	ofstream out(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if (out.fail()) Error("Cannot write the landmarks " + filename);
+	static const char zeros[8] = { 0 };
+	out.write((const char *) &header, sizeof header);
+	out.write((const char *) landmarks, count * sizeof(int));
+	if (count % 2 != 0) out.write(zeros, sizeof(int));
+	out.write((const char *) table, size_t(numNodes) * count * sizeof(double));
+	out.close();
+	if (out.fail()) Error("Cannot write the landmarks " + filename);
+}
+
+bool Landmarks::load(string filename, Graph & graph)
+{
+	clear();
+	ifstream in(filename.c_str(), ios::in | ios::binary);
+	if (in.fail()) return false;
+	landmarkHeaderT header;
+	in.read((char *) &header, sizeof header);
+	if (in.fail() || memcmp(header.magic, LandmarkMagic, sizeof header.magic) != 0
+		|| header.version != LandmarkVersion || header.byteOrder != LandmarkByteOrder
+		|| header.numNodes != graph.numNodes() || header.numArcs != graph.numArcs()
+		|| header.count < 0 || header.count > header.numNodes
+		|| header.fingerprint != GraphFingerprint(graph)) {
+		return false;
+	}
+	landmarks = new int[header.count];
+	table = new double[size_t(header.numNodes) * header.count];
+	in.read((char *) landmarks, header.count * sizeof(int));
+	if (header.count % 2 != 0) in.ignore(sizeof(int));
+	in.read((char *) table, size_t(header.numNodes) * header.count * sizeof(double));
+	if (in.fail()) {
+		clear();
+		return false;
+	}
+	count = header.count;
+	numNodes = header.numNodes;
+	numArcs = header.numArcs;
+	fingerprint = header.fingerprint;
+	return true;
+}
+
+bool Landmarks::isBuiltFor(Graph & graph)
+{
+	return landmarks != NULL && numNodes == graph.numNodes() && numArcs == graph.numArcs()
+		&& fingerprint == GraphFingerprint(graph);
+}
+
+/* Function: BoundFromRows
+ * -----------------------
+ * Returns the largest |dist(L, t) - dist(L, v)| over the landmarks,
+ * given the table rows of v and t. A landmark that reaches neither
+ * city says nothing; one that reaches exactly one of them proves
+ * there is no path at all.
+ */
+static double BoundFromRows(const double *from, const double *to, int count)
+{
+	double bound = 0;
+	for (int i = 0; i < count; i++) {
+		if (from[i] == NoDistance || to[i] == NoDistance) {
+			if (from[i] != to[i]) return NoDistance;
+			continue;
+		}
+		double difference = to[i] - from[i];
+		if (difference < 0) difference = -difference;
+		if (difference > bound) bound = difference;
+	}
+	return bound;
+}
+
+double Landmarks::lowerBound(int node, int target)
+{
+	return BoundFromRows(table + size_t(node) * count, table + size_t(target) * count, count);
+}
+
+
+LandmarkHeuristic::LandmarkHeuristic(Landmarks & landmarks)
+{
+	this->landmarks = &landmarks;
+	targetRow = new double[landmarks.count];
+}
+
+LandmarkHeuristic::~LandmarkHeuristic()
+{
+	delete[] targetRow;
+}
+
+void LandmarkHeuristic::setTarget(int target)
+{
+	const double *row = landmarks->table + size_t(target) * landmarks->count;
+	for (int i = 0; i < landmarks->count; i++) {
+		targetRow[i] = row[i];
+	}
+}
+
+double LandmarkHeuristic::estimate(int node)
+{
+	return BoundFromRows(landmarks->table + size_t(node) * landmarks->count, targetRow, landmarks->count);
+}
@@ -0,0 +1,168 @@
+/*
+ * File: landmarks.h
+ * -----------------
+ * Landmarks for the ALT search (A*, Landmarks, Triangle inequality).
+ * A few cities are picked as landmarks and the distance from each of
+ * them to every city is computed ahead of time. For any landmark L,
+ * the triangle inequality gives
+ *
+ *	dist(v, t) >= |dist(L, t) - dist(L, v)|
+ *
+ * so the largest of these over all landmarks is a lower bound that A*
+ * can use on any query, and a much tighter one than the straight-line
+ * distance. The tables cost one full search per landmark to build and
+ * k * V distances of memory, and can be saved next to the graph.
+ */
+
+#ifndef _landmarks_h
+#define _landmarks_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "graph.h"
+#include "search.h"
+
+
+/*
+ * Constant: DefaultLandmarks
+ * --------------------------
+ * The number of landmarks picked unless the caller asks for another.
+ */
+const int DefaultLandmarks = 16;
+
+
+/*
+ * Class: Landmarks
+ * ----------------
+ * The landmark ids and the distance table for one graph. The table is
+ * stored one city at a time, the distances of a city from all of the
+ * landmarks next to each other, which is the order a lower bound
+ * reads them in.
+ */
+class Landmarks {
+  public:
+
+	Landmarks();
+	~Landmarks();
+
+	/*
+	 * Member function: build
+	 * Usage: landmarks.build(graph, 16);
+	 * ----------------------------------
+	 * Picks count landmarks by farthest-point selection and fills in
+	 * their distance tables. The first landmark is the city farthest
+	 * from city 0; each one after that is the city farthest from all
+	 * of the landmarks picked so far. Cities that no landmark can reach
+	 * count as farthest of all, so every connected piece of the graph
+	 * gets a landmark while there are landmarks left to give.
+	 */
+	void build(Graph & graph, int count = DefaultLandmarks);
+
+	/*
+	 * Member function: clear
+	 * Usage: landmarks.clear();
+	 * -------------------------
+	 * Forgets the landmarks, e.g. because another graph was loaded.
+	 */
+	void clear();
+
+	/*
+	 * Member function: save
+	 * Usage: landmarks.save("USA.landmarks");
+	 * ---------------------------------------
+	 * Writes the landmarks and tables to a binary file, together with
+	 * a fingerprint of the graph they were built for. Raises an error
+	 * if the file cannot be written.
+	 */
+	void save(string filename);
+
+	/*
+	 * Member function: load
+	 * Usage: if (landmarks.load("USA.landmarks", graph)) . . .
+	 * --------------------------------------------------------
+	 * Reads landmarks written by save. Returns false, leaving the
+	 * landmarks empty, if the file does not exist, is not a landmark
+	 * file this version can read, or was built for a different graph.
+	 */
+	bool load(string filename, Graph & graph);
+
+	/*
+	 * Member function: isBuiltFor
+	 * Usage: if (!landmarks.isBuiltFor(graph)) . . .
+	 * ----------------------------------------------
+	 * Returns true if the landmarks were built (or loaded) for a graph
+	 * with the same fingerprint as this one.
+	 */
+	bool isBuiltFor(Graph & graph);
+
+	/*
+	 * Member function: lowerBound
+	 * Usage: double d = landmarks.lowerBound(v, t);
+	 * ---------------------------------------------
+	 * Returns a lower bound on the distance from v to t. It is
+	 * NoDistance if some landmark reaches one of them but not the
+	 * other, since then they lie in different parts of the graph.
+	 */
+	double lowerBound(int node, int target);
+
+	int size();
+	int getLandmark(int index);
+
+  private:
+	DISALLOW_COPYING(Landmarks)
+
+	int count;
+	int numNodes;
+	int *landmarks;
+	double *table;			// numNodes * count entries; city v, landmark i at table[v * count + i]
+	int numArcs;
+	unsigned fingerprint;
+
+	friend class LandmarkHeuristic;
+};
+
+
+/*
+ * Class: LandmarkHeuristic
+ * ------------------------
+ * The ALT lower bound as an A* heuristic. It is consistent, so A* with
+ * it settles each city at most once. setTarget copies the target's
+ * row of the table so that each estimate reads only the city's row.
+ */
+class LandmarkHeuristic : public Heuristic {
+  public:
+	LandmarkHeuristic(Landmarks & landmarks);
+	~LandmarkHeuristic();
+	void setTarget(int target);
+	double estimate(int node);
+
+  private:
+	DISALLOW_COPYING(LandmarkHeuristic)
+
+	Landmarks *landmarks;
+	double *targetRow;
+};
+
+
+/*
+ * Function: GraphFingerprint
+ * Usage: unsigned print = GraphFingerprint(graph);
+ * ------------------------------------------------
+ * Returns a hash of the graph's arcs, used together with the numbers
+ * of cities and arcs to check that a file of precomputed data belongs
+ * to the graph it is being loaded for.
+ */
+unsigned GraphFingerprint(Graph & graph);
+
+
+inline int Landmarks::size()
+{
+	return count;
+}
+
+inline int Landmarks::getLandmark(int index)
+{
+	return landmarks[index];
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * File: mappedfile.cpp
+ * --------------------
+ * Implementation of the MappedFile class declared in mappedfile.h.
+ */
+
+#include "mappedfile.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+MappedFile::MappedFile()
+{
+	contents = NULL;
+	length = 0;
+	mapped = false;
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(string filename)
+{
+	close();
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+		::close(fd);
+		return false;
+	}
+	length = size_t(info.st_size);
+	if (length > 0) {
+		void *map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			contents = (const char *) map;
+			mapped = true;
+		}
+	}
+	if (!mapped) {
+		char *buffer = new char[length + 1];
+		size_t total = 0;
+		while (total < length) {
+			ssize_t count = read(fd, buffer + total, length - total);
+			if (count <= 0) break;
+			total += count;
+		}
+		length = total;
+		contents = buffer;
+	}
+	::close(fd);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (contents != NULL) {
+		if (mapped) {
+			munmap((void *) contents, length);
+		} else {
+			delete[] contents;
+		}
+	}
+	contents = NULL;
+	length = 0;
+	mapped = false;
+}
@@ -0,0 +1,75 @@
+/*
+ * File: mappedfile.h
+ * ------------------
+ * Gives read-only access to the whole contents of a file as one block
+ * of memory. The file is memory-mapped where possible, so the operating
+ * system pages it in on demand and nothing is copied.
+ */
+
+#ifndef _mappedfile_h
+#define _mappedfile_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include <cstddef>
+
+
+/*
+ * Class: MappedFile
+ * -----------------
+ * If the file cannot be mapped (an empty file, or a file system that
+ * does not support it), it is read into a buffer instead; either way
+ * data() points at size() bytes until the file is closed.
+ */
+class MappedFile {
+  public:
+
+	MappedFile();
+	~MappedFile();
+
+	/*
+	 * Member function: open
+	 * Usage: if (file.open(filename)) . . .
+	 * -------------------------------------
+	 * Opens the file, closing any file that was already open. Returns
+	 * false if it is missing or is not a regular file.
+	 */
+	bool open(string filename);
+
+	/*
+	 * Member function: close
+	 * Usage: file.close();
+	 * --------------------
+	 * Releases the memory. Also done by the destructor.
+	 */
+	void close();
+
+	bool isOpen();
+	const char *data();
+	size_t size();
+
+  private:
+	DISALLOW_COPYING(MappedFile)
+
+	const char *contents;
+	size_t length;
+	bool mapped;			// true if contents is an mmap, false if it is a new[] buffer
+};
+
+
+inline bool MappedFile::isOpen()
+{
+	return contents != NULL;
+}
+
+inline const char *MappedFile::data()
+{
+	return contents;
+}
+
+inline size_t MappedFile::size()
+{
+	return length;
+}
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * File: matrix.cpp
+ * ----------------
+ * Implementation of the distance matrices declared in matrix.h.
+ */
+
+#include "matrix.h"
+#include "graphreader.h"
+#include "parallel.h"
+#include "search.h"
+#include "strutils.h"
+#include <cstring>
+#include <fstream>
+#include <pthread.h>
+
+
+/* Matrix file format
+ * ------------------
+ * A matrixHeaderT, then int sources[numSources] and int
+ * targets[numTargets] (the city ids), padded to a multiple of 8
+ * bytes, then double distances[numSources * numTargets] one source
+ * after another as in memory. A missing path is stored as NoDistance,
+ * which is IEEE infinity. As with graph snapshots, the byte order mark
+ * tells a reader on a machine of the other byte order to swap, and
+ * any change to the layout must bump MatrixVersion.
+ */
+
+static const char MatrixMagic[8] = "PFMATRX";
+static const int MatrixVersion = 1;
+static const int MatrixByteOrder = 0x01020304;
+
+struct matrixHeaderT {
+	char magic[8];
+	int version;
+	int byteOrder;
+	int numSources;
+	int numTargets;
+};
+
+
+bool ReadCityList(string filename, Graph & graph, Vector<int> & cities)
+{
+	GraphReader in;
+	if (!in.open(filename)) return false;
+	string name;
+	while (in.readWord(name)) {
+		int id = graph.findNode(name);
+		if (id == NoSuchNode) {
+			Error("The city " + name + " on line " + IntegerToString(in.lineNumber()) + " is not in the graph.");
+		}
+		cities.add(id);
+	}
+	return true;
+}
+
+
+/* Function: SearchToTargets
+ * -------------------------
+ * Runs Dijkstra's algorithm from source in the workspace's forward
+ * side until numTargets cities marked in isTarget have been settled
+ * or there is nothing left to settle. Either way, every target that
+ * has been reached by then has its final distance, and one that has
+ * not been reached has no path to it.
+ */
+static void SearchToTargets(Graph & graph, int source, bool isTarget[], int numTargets, SearchWorkspace & workspace)
+{
+	workspace.prepare(graph.numNodes());
+	searchSideT & side = workspace.forward();
+	IndexedPQueue<double> & pq = *side.pq;
+	side.distance[source] = 0;
+	side.markReached(source);
+	pq.enqueue(source, 0);
+	while (numTargets > 0 && !pq.isEmpty()) {
+		int city = pq.dequeueMin();
+		if (isTarget[city]) numTargets--;
+		for (int slot = graph.firstSlot(city); slot < graph.endSlot(city); slot++) {
+			int neighbor = graph.targetAt(slot);
+			double newDistance = side.distance[city] + graph.weightAt(slot);
+			if (!side.isReached(neighbor)) {
+				side.markReached(neighbor);
+				pq.enqueue(neighbor, newDistance);
+			} else if (newDistance < side.distance[neighbor]) {
+				pq.decreaseKey(neighbor, newDistance);
+			} else {
+				continue;
+			}
+			side.distance[neighbor] = newDistance;
+		}
+	}
+}
+
+/* Implementation notes: DistanceMatrix
+ * ------------------------------------
+ * isTarget and the number of distinct targets are worked out once and
+ * only read by the threads. A source's search can take anything from
+ * a few cities to the whole graph, so the threads take one source at
+ * a time from a shared counter, as the batch queries do, rather than
+ * each taking a fixed share. Each thread keeps its own workspace and
+ * writes only the rows of its own sources.
+ */
+struct matrixT {
+	Graph *graph;
+	Vector<int> *sources;
+	Vector<int> *targets;
+	bool *isTarget;
+	int numDistinctTargets;
+	double *matrix;
+	int next;						// the first source no thread has taken yet
+	pthread_mutex_t lock;
+};
+
+static void FillRows(int /* thread */, int /* numThreads */, matrixT & state)
+{
+	Vector<int> & sources = *state.sources;
+	Vector<int> & targets = *state.targets;
+	SearchWorkspace workspace;
+	while (true) {
+		pthread_mutex_lock(&state.lock);
+		int row = state.next++;
+		pthread_mutex_unlock(&state.lock);
+		if (row >= sources.size()) break;
+		SearchToTargets(*state.graph, sources[row], state.isTarget, state.numDistinctTargets, workspace);
+		searchSideT & side = workspace.forward();
+		double *distances = state.matrix + size_t(row) * targets.size();
+		for (int j = 0; j < targets.size(); j++) {
+			distances[j] = side.isReached(targets[j]) ? side.distance[targets[j]] : NoDistance;
+		}
+	}
+}
+
+void DistanceMatrix(Graph & graph, Vector<int> & sources, Vector<int> & targets, double matrix[])
+{
+	matrixT state;
+	state.graph = &graph;
+	state.sources = &sources;
+	state.targets = &targets;
+	state.isTarget = new bool[graph.numNodes()];
+	state.numDistinctTargets = 0;
+	state.matrix = matrix;
+	state.next = 0;
+	for (int v = 0; v < graph.numNodes(); v++) {
+		state.isTarget[v] = false;
+	}
+	for (int j = 0; j < targets.size(); j++) {
+		if (!state.isTarget[targets[j]]) state.numDistinctTargets++;
+		state.isTarget[targets[j]] = true;
+	}
+	pthread_mutex_init(&state.lock, NULL);
+	RunInParallel(FillRows, state, ChooseThreadCount(sources.size(), 1));
+	pthread_mutex_destroy(&state.lock);
+	delete[] state.isTarget;
+}
+
+
+void WriteMatrixText(string filename, Graph & graph, Vector<int> & sources, Vector<int> & targets,
+					 double matrix[])
+{
+	ofstream out(filename.c_str());
+	if (out.fail()) Error("Cannot write the matrix " + filename);
+	out.precision(15);
+	for (int j = 0; j < targets.size(); j++) {
+		out << "," << graph.getName(targets[j]);
+	}
+	out << endl;
+	for (int i = 0; i < sources.size(); i++) {
+		out << graph.getName(sources[i]);
+		const double *distances = matrix + size_t(i) * targets.size();
+		for (int j = 0; j < targets.size(); j++) {
+			out << ",";
+			if (distances[j] != NoDistance) out << distances[j];
+		}
+		out << endl;
+	}
+	out.close();
+	if (out.fail()) Error("Cannot write the matrix " + filename);
+}
+
+void WriteMatrixBinary(string filename, Vector<int> & sources, Vector<int> & targets, double matrix[])
+{
+	matrixHeaderT header;
+	memset(&header, 0, sizeof header);
+	memcpy(header.magic, MatrixMagic, sizeof header.magic);
+	header.version = MatrixVersion;
+	header.byteOrder = MatrixByteOrder;
+	header.numSources = sources.size();
+	header.numTargets = targets.size();
+
+	ofstream out(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if (out.fail()) Error("Cannot write the matrix " + filename);
+	static const char zeros[8] = { 0 };
+	out.write((const char *) &header, sizeof header);
+	for (int i = 0; i < sources.size(); i++) {
+		int id = sources[i];
+		out.write((const char *) &id, sizeof id);
+	}
+	for (int j = 0; j < targets.size(); j++) {
+		int id = targets[j];
+		out.write((const char *) &id, sizeof id);
+	}
+	if ((sources.size() + targets.size()) % 2 != 0) out.write(zeros, sizeof(int));
+	out.write((const char *) matrix, size_t(sources.size()) * targets.size() * sizeof(double));
+	out.close();
+	if (out.fail()) Error("Cannot write the matrix " + filename);
+}
@@ -0,0 +1,66 @@
+/*
+ * File: matrix.h
+ * --------------
+ * Distance matrices: the length of the shortest path from each of a
+ * list of source cities to each of a list of target cities. Every
+ * source gets one search that runs until it has settled all of the
+ * targets, and the searches for different sources run on different
+ * threads, so an S x T matrix costs S searches rather than S * T.
+ */
+
+#ifndef _matrix_h
+#define _matrix_h
+
+#include "genlib.h"
+#include "vector.h"
+#include "graph.h"
+
+
+/*
+ * Function: ReadCityList
+ * Usage: if (ReadCityList("depots.txt", graph, cities)) . . .
+ * -----------------------------------------------------------
+ * Reads a file of city names separated by white space (usually one
+ * per line) and adds their ids to the vector in the order they are
+ * in the file. Returns false if the file cannot be opened. Raises an
+ * error if it names a city that is not in the graph.
+ */
+bool ReadCityList(string filename, Graph & graph, Vector<int> & cities);
+
+/*
+ * Function: DistanceMatrix
+ * Usage: DistanceMatrix(graph, sources, targets, matrix);
+ * -------------------------------------------------------
+ * Fills matrix, which must have room for sources.size() *
+ * targets.size() entries, with the distances from the sources to the
+ * targets one source after another: the distance from sources[i] to
+ * targets[j] is matrix[i * targets.size() + j], or NoDistance if
+ * there is no path. The sources are shared out between
+ * GetThreadCount() threads.
+ */
+void DistanceMatrix(Graph & graph, Vector<int> & sources, Vector<int> & targets, double matrix[]);
+
+/*
+ * Function: WriteMatrixText
+ * Usage: WriteMatrixText("table.csv", graph, sources, targets, matrix);
+ * ---------------------------------------------------------------------
+ * Writes the matrix as comma-separated values: a header row with the
+ * names of the targets, then one row per source starting with its
+ * name. There is nothing between the commas where there is no path.
+ * Raises an error if the file cannot be written.
+ */
+void WriteMatrixText(string filename, Graph & graph, Vector<int> & sources, Vector<int> & targets,
+					 double matrix[]);
+
+/*
+ * Function: WriteMatrixBinary
+ * Usage: WriteMatrixBinary("table.matrix", sources, targets, matrix);
+ * -------------------------------------------------------------------
+ * Writes the matrix as a binary file (the format is described in
+ * matrix.cpp), which is about half the size of the text and can be
+ * read straight into an array. Raises an error if the file cannot
+ * be written.
+ */
+void WriteMatrixBinary(string filename, Vector<int> & sources, Vector<int> & targets, double matrix[]);
+
+#endif
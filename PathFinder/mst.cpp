@@ -0,0 +1,429 @@
+/*
+ * File: mst.cpp
+ * -------------
+ * Implementation of the spanning tree algorithms declared in mst.h.
+ */
+
+#include "mst.h"
+#include "edgesort.h"
+#include "unionfind.h"
+#include "parallel.h"
+#include "strutils.h"
+#include "pqueue.h"
+
+/*
+ * Filter-Kruskal stops partitioning and sorts outright once a range
+ * has this many edges or fewer.
+ */
+static const int FilterKruskalCutoff = 4096;
+
+/*
+ * Boruvka only starts threads when each one gets at least this many
+ * cities to scan.
+ */
+static const int MinCitiesPerThread = 4096;
+
+
+double SpanningTree(Graph & graph, mstAlgorithmT algorithm, Vector<edgeT> & tree)
+{
+	switch (algorithm) {
+	  case KruskalMST: KruskalSpanningTree(graph, tree); break;
+	  case FilterKruskalMST: FilterKruskalSpanningTree(graph, tree); break;
+	  case BoruvkaMST: BoruvkaSpanningTree(graph, tree); break;
+	  case PrimMST: PrimSpanningTree(graph, tree); break;
+	  case DensePrimMST: DensePrimSpanningTree(graph, tree); break;
+	  case AutoMST: SpanningTree(graph, PickMSTAlgorithm(graph), tree); break;
+	}
+	double length = 0;
+	for (int i = 0; i < tree.size(); i++) {
+		length += tree[i].distance;
+	}
+	return length;
+}
+
+string MSTAlgorithmName(mstAlgorithmT algorithm)
+{
+	switch (algorithm) {
+	  case KruskalMST: return "Kruskal";
+	  case FilterKruskalMST: return "Filter-Kruskal";
+	  case BoruvkaMST: return "Boruvka";
+	  case PrimMST: return "Prim (heap)";
+	  case DensePrimMST: return "Prim (array scan)";
+	  case AutoMST: return "Automatic";
+	}
+	return "";
+}
+
+mstAlgorithmT StringToMSTAlgorithm(string name)
+{
+	name = ConvertToLowerCase(name);
+	if (name == "kruskal") return KruskalMST;
+	if (name == "filter" || name == "filter-kruskal") return FilterKruskalMST;
+	if (name == "boruvka") return BoruvkaMST;
+	if (name == "prim") return PrimMST;
+	if (name == "dense-prim" || name == "dense") return DensePrimMST;
+	if (name == "auto") return AutoMST;
+	Error("Unknown spanning tree algorithm \"" + name + "\" (expected kruskal, filter, boruvka, prim, dense-prim or auto)");
+	return KruskalMST;
+}
+
+/* Function: CopyArcs
+ * ------------------
+ * Returns a new array holding every arc of the graph. The caller
+ * deletes it.
+ */
+static edgeT *CopyArcs(Graph & graph)
+{
+	edgeT *edges = new edgeT[graph.numArcs()];
+	for (int i = 0; i < graph.numArcs(); i++) {
+		edges[i] = graph.getArc(i);
+	}
+	return edges;
+}
+
+/* Function: AddInOrder
+ * --------------------
+ * The core Kruskal step: goes through edges[start, end), which must
+ * already be in order, and keeps every edge that joins two islands.
+ * Stops early once the tree spans all of the cities.
+ */
+static void AddInOrder(edgeT edges[], int start, int end, UnionFind & islands, Vector<edgeT> & tree)
+{
+	for (int i = start; i < end && tree.size() < islands.size() - 1; i++) {
+		if (islands.merge(edges[i].from, edges[i].to)) tree.add(edges[i]);
+	}
+}
+
+
+/* Kruskal
+ * -------
+ * Sort everything, then add shortest first.
+ */
+void KruskalSpanningTree(Graph & graph, Vector<edgeT> & tree)
+{
+	int numArcs = graph.numArcs();
+	edgeT *edges = CopyArcs(graph);
+	SortEdges(edges, numArcs);
+	UnionFind islands(graph.numNodes());
+	AddInOrder(edges, 0, numArcs, islands, tree);
+	delete[] edges;
+}
+
+
+/* Filter-Kruskal
+ * --------------
+ * Like quicksort, the edges are split around a pivot distance, but
+ * the shorter side is fully processed before the longer side is even
+ * looked at. By then most of the longer edges join cities that are
+ * already in the same island, so they are filtered out and never
+ * sorted. Small ranges are sorted and scanned directly.
+ */
+
+static double MedianOfThree(double a, double b, double c)
+{
+	if (a < b) {
+		if (b < c) return b;
+		return (a < c) ? c : a;
+	} else {
+		if (a < c) return a;
+		return (b < c) ? c : b;
+	}
+}
+
+static void SwapEdges(edgeT edges[], int i, int j)
+{
+	edgeT temp = edges[i];
+	edges[i] = edges[j];
+	edges[j] = temp;
+}
+
+/* Function: Filter
+ * ----------------
+ * Moves the edges of [start, end) that still join two different
+ * islands to the front of the range and returns where they end.
+ */
+static int Filter(edgeT edges[], int start, int end, UnionFind & islands)
+{
+	int kept = start;
+	for (int i = start; i < end; i++) {
+		if (!islands.connected(edges[i].from, edges[i].to)) edges[kept++] = edges[i];
+	}
+	return kept;
+}
+
+static void FilterKruskalRange(edgeT edges[], int start, int end, UnionFind & islands, Vector<edgeT> & tree)
+{
+	if (end - start <= FilterKruskalCutoff) {
+		SortEdges(edges + start, end - start);
+		AddInOrder(edges, start, end, islands, tree);
+		return;
+	}
+
+	//three-way partition: [start, less) < pivot, [less, greater) == pivot, [greater, end) > pivot
+	double pivot = MedianOfThree(edges[start].distance, edges[(start + end) / 2].distance, edges[end - 1].distance);
+	int less = start, i = start, greater = end;
+	while (i < greater) {
+		if (edges[i].distance < pivot) {
+			SwapEdges(edges, less++, i++);
+		} else if (edges[i].distance > pivot) {
+			SwapEdges(edges, i, --greater);
+		} else {
+			i++;
+		}
+	}
+
+	FilterKruskalRange(edges, start, less, islands, tree);
+	AddInOrder(edges, less, greater, islands, tree);				//all the same distance, so already in order
+	if (tree.size() == islands.size() - 1) return;					//spanning already, skip the long edges entirely
+	int kept = Filter(edges, greater, end, islands);
+	FilterKruskalRange(edges, greater, kept, islands, tree);
+}
+
+void FilterKruskalSpanningTree(Graph & graph, Vector<edgeT> & tree)
+{
+	edgeT *edges = CopyArcs(graph);
+	UnionFind islands(graph.numNodes());
+	FilterKruskalRange(edges, 0, graph.numArcs(), islands, tree);
+	delete[] edges;
+}
+
+
+/* Boruvka
+ * -------
+ * Each round, every island picks the shortest edge leaving it, and
+ * all of those edges are added at once, which at least halves the
+ * number of islands. Finding the shortest edges is the expensive part
+ * (it looks at every arc), and it is split across threads by city:
+ * each thread records the best outgoing edge of each of its cities.
+ * The per-island choice and the merging are then done on one thread.
+ *
+ * Ties are broken by the ids of the endpoints so that every island
+ * agrees on which of two equal edges is shorter; otherwise two islands
+ * could pick different equal edges and close a cycle.
+ */
+
+struct boruvkaT {
+	Graph *graph;
+	int *island;		// island[city] is the UnionFind root of the city for this round
+	int *bestSlot;		// bestSlot[city] is the adjacency slot of its best outgoing edge, or -1
+};
+
+static bool IsShorter(double distance1, int a1, int b1, double distance2, int a2, int b2)
+{
+	if (distance1 != distance2) return distance1 < distance2;
+	int low1 = (a1 < b1) ? a1 : b1, low2 = (a2 < b2) ? a2 : b2;
+	if (low1 != low2) return low1 < low2;
+	int high1 = (a1 < b1) ? b1 : a1, high2 = (a2 < b2) ? b2 : a2;
+	return high1 < high2;
+}
+
+static void FindShortestOutgoing(int thread, int numThreads, boruvkaT & state)
+{
+	Graph & graph = *state.graph;
+	int start, end;
+	SplitRange(graph.numNodes(), thread, numThreads, start, end);
+	for (int city = start; city < end; city++) {
+		int best = -1;
+		for (int slot = graph.firstSlot(city); slot < graph.endSlot(city); slot++) {
+			int neighbor = graph.targetAt(slot);
+			if (state.island[neighbor] == state.island[city]) continue;
+			if (best == -1 || IsShorter(graph.weightAt(slot), city, neighbor,
+										graph.weightAt(best), city, graph.targetAt(best))) {
+				best = slot;
+			}
+		}
+		state.bestSlot[city] = best;
+	}
+}
+
+void BoruvkaSpanningTree(Graph & graph, Vector<edgeT> & tree)
+{
+	int numCities = graph.numNodes();
+	UnionFind islands(numCities);
+	boruvkaT state;
+	state.graph = &graph;
+	state.island = new int[numCities];
+	state.bestSlot = new int[numCities];
+	int *islandBest = new int[numCities];			// city holding the best edge of each island, or -1
+	for (int i = 0; i < numCities; i++) {
+		state.island[i] = i;
+	}
+	int numThreads = ChooseThreadCount(numCities, MinCitiesPerThread);
+
+	while (true) {
+		RunInParallel(FindShortestOutgoing, state, numThreads);
+
+		for (int i = 0; i < numCities; i++) {
+			islandBest[i] = -1;
+		}
+		for (int city = 0; city < numCities; city++) {
+			int slot = state.bestSlot[city];
+			if (slot == -1) continue;
+			int island = state.island[city];
+			int current = islandBest[island];
+			if (current == -1 || IsShorter(graph.weightAt(slot), city, graph.targetAt(slot),
+										   graph.weightAt(state.bestSlot[current]), current,
+										   graph.targetAt(state.bestSlot[current]))) {
+				islandBest[island] = city;
+			}
+		}
+
+		int merged = 0;
+		for (int island = 0; island < numCities; island++) {
+			int city = islandBest[island];
+			if (city == -1) continue;
+			int slot = state.bestSlot[city];
+			edgeT edge;
+			edge.from = city;
+			edge.to = graph.targetAt(slot);
+			edge.distance = graph.weightAt(slot);
+			if (islands.merge(edge.from, edge.to)) {		// two islands may have picked the same edge
+				tree.add(edge);
+				merged++;
+			}
+		}
+		if (merged == 0) break;								// no island has an outgoing edge left
+
+		for (int city = 0; city < numCities; city++) {
+			state.island[city] = islands.find(city);
+		}
+	}
+	delete[] state.island;
+	delete[] state.bestSlot;
+	delete[] islandBest;
+}
+
+
+/* Prim
+ * ----
+ * Grows the tree one city at a time. Every city outside the tree
+ * keeps the length of the shortest arc connecting it to the tree
+ * (its key) and which tree city that arc comes from. The closest
+ * city joins next, and its arcs may lower the keys of its neighbors.
+ * If the graph is not connected, a new tree is started from the
+ * first city not yet reached, giving a spanning forest.
+ *
+ * The two versions differ only in how the closest city is found:
+ * an IndexedPQueue (decreaseKey on every improved key) or a scan
+ * over the key array.
+ */
+
+struct primT {
+	double *key;		// length of the shortest known arc into the tree
+	int *from;			// tree city at the other end of that arc, -1 if none yet
+	bool *inTree;
+};
+
+static void InitPrim(primT & prim, int numCities)
+{
+	prim.key = new double[numCities];
+	prim.from = new int[numCities];
+	prim.inTree = new bool[numCities];
+	for (int i = 0; i < numCities; i++) {
+		prim.from[i] = -1;
+		prim.inTree[i] = false;
+	}
+}
+
+static void FreePrim(primT & prim)
+{
+	delete[] prim.key;
+	delete[] prim.from;
+	delete[] prim.inTree;
+}
+
+/* Function: JoinTree
+ * ------------------
+ * Adds city to the tree, recording the arc it was reached by unless
+ * it is the root of a new tree. Lowering the neighbors' keys is left
+ * to the caller, which knows how the keys are stored.
+ */
+static void JoinTree(primT & prim, int city, Vector<edgeT> & tree)
+{
+	prim.inTree[city] = true;
+	if (prim.from[city] != -1) {
+		edgeT edge;
+		edge.from = prim.from[city];
+		edge.to = city;
+		edge.distance = prim.key[city];
+		tree.add(edge);
+	}
+}
+
+void PrimSpanningTree(Graph & graph, Vector<edgeT> & tree)
+{
+	int numCities = graph.numNodes();
+	primT prim;
+	InitPrim(prim, numCities);
+	IndexedPQueue<double> pq(numCities);
+	for (int root = 0; root < numCities; root++) {
+		if (prim.inTree[root]) continue;
+		prim.key[root] = 0;
+		pq.enqueue(root, 0);
+		while (!pq.isEmpty()) {
+			int city = pq.dequeueMin();
+			JoinTree(prim, city, tree);
+			for (int slot = graph.firstSlot(city); slot < graph.endSlot(city); slot++) {
+				int neighbor = graph.targetAt(slot);
+				double distance = graph.weightAt(slot);
+				if (prim.inTree[neighbor]) continue;
+				if (prim.from[neighbor] == -1) {
+					prim.key[neighbor] = distance;
+					prim.from[neighbor] = city;
+					pq.enqueue(neighbor, distance);
+				} else if (distance < prim.key[neighbor]) {
+					prim.key[neighbor] = distance;
+					prim.from[neighbor] = city;
+					pq.decreaseKey(neighbor, distance);
+				}
+			}
+		}
+	}
+	FreePrim(prim);
+}
+
+void DensePrimSpanningTree(Graph & graph, Vector<edgeT> & tree)
+{
+	int numCities = graph.numNodes();
+	primT prim;
+	InitPrim(prim, numCities);
+	for (int joined = 0; joined < numCities; joined++) {
+		int city = -1;								// closest city outside the tree, or a new root
+		for (int i = 0; i < numCities; i++) {
+			if (prim.inTree[i] || prim.from[i] == -1) continue;
+			if (city == -1 || prim.key[i] < prim.key[city]) city = i;
+		}
+		if (city == -1) {							// nothing reachable is left, start a new tree
+			for (city = 0; prim.inTree[city]; city++)
+				;
+			prim.key[city] = 0;
+		}
+		JoinTree(prim, city, tree);
+		for (int slot = graph.firstSlot(city); slot < graph.endSlot(city); slot++) {
+			int neighbor = graph.targetAt(slot);
+			if (prim.inTree[neighbor]) continue;
+			if (prim.from[neighbor] == -1 || graph.weightAt(slot) < prim.key[neighbor]) {
+				prim.key[neighbor] = graph.weightAt(slot);
+				prim.from[neighbor] = city;
+			}
+		}
+	}
+	FreePrim(prim);
+}
+
+
+/* Implementation notes: PickMSTAlgorithm
+ * --------------------------------------
+ * The counts are kept as doubles so that n*(n-1)/2 cannot overflow
+ * an int on large graphs.
+ */
+mstAlgorithmT PickMSTAlgorithm(Graph & graph)
+{
+	double numCities = graph.numNodes();
+	double numArcs = graph.numArcs();
+	if (numCities < 2) return KruskalMST;
+	double pairs = numCities * (numCities - 1) / 2;
+	if (numArcs >= pairs / 2) return DensePrimMST;
+	if (2 * numArcs / numCities >= DenseDegree) return PrimMST;
+	return KruskalMST;
+}
@@ -0,0 +1,92 @@
+/*
+ * File: mst.h
+ * -----------
+ * Minimum spanning tree algorithms over the Graph class. All of them
+ * find a tree of the same total length; they differ in how much of
+ * the edge list they need to sort and how well they use several
+ * threads.
+ */
+
+#ifndef _mst_h
+#define _mst_h
+
+#include "genlib.h"
+#include "vector.h"
+#include "graph.h"
+
+
+/*
+ * Type: mstAlgorithmT
+ * -------------------
+ * Names the available spanning tree algorithms.
+ */
+enum mstAlgorithmT {
+	KruskalMST,				// sort every edge, then add them shortest first
+	FilterKruskalMST,		// partition around a pivot, drop edges inside an island before sorting them
+	BoruvkaMST,				// every island picks its shortest outgoing edge, in parallel rounds
+	PrimMST,				// grow one tree from a city, closest city next, using an indexed heap
+	DensePrimMST,			// Prim's algorithm picking the closest city with a plain array scan
+	AutoMST					// one of the above, picked from the number of edges per city
+};
+
+const int NumMSTAlgorithms = 6;
+
+
+/*
+ * Function: SpanningTree
+ * Usage: length = SpanningTree(graph, BoruvkaMST, tree);
+ * ------------------------------------------------------
+ * Fills tree with the edges of a minimum spanning tree of the graph
+ * (a spanning forest if the graph is not connected) using the given
+ * algorithm, and returns the total length of those edges.
+ */
+double SpanningTree(Graph & graph, mstAlgorithmT algorithm, Vector<edgeT> & tree);
+
+/*
+ * Functions: KruskalSpanningTree, FilterKruskalSpanningTree, BoruvkaSpanningTree,
+ *            PrimSpanningTree, DensePrimSpanningTree
+ * Usage: KruskalSpanningTree(graph, tree);
+ * ----------------------------------------
+ * The individual algorithms behind SpanningTree. The heap-based Prim
+ * runs in O(E log V); the array-scan Prim runs in O(V^2 + E), which
+ * is better once nearly every pair of cities is connected because it
+ * never has to touch a heap.
+ */
+void KruskalSpanningTree(Graph & graph, Vector<edgeT> & tree);
+void FilterKruskalSpanningTree(Graph & graph, Vector<edgeT> & tree);
+void BoruvkaSpanningTree(Graph & graph, Vector<edgeT> & tree);
+void PrimSpanningTree(Graph & graph, Vector<edgeT> & tree);
+void DensePrimSpanningTree(Graph & graph, Vector<edgeT> & tree);
+
+/*
+ * Function: PickMSTAlgorithm
+ * Usage: algorithm = PickMSTAlgorithm(graph);
+ * -------------------------------------------
+ * Returns the algorithm AutoMST runs on this graph. Graphs where at
+ * least half of all city pairs are connected get the array-scan
+ * Prim, graphs averaging DenseDegree or more arcs per city get the
+ * heap-based Prim, and sparser graphs get Kruskal.
+ */
+mstAlgorithmT PickMSTAlgorithm(Graph & graph);
+
+const int DenseDegree = 32;
+
+/*
+ * Function: MSTAlgorithmName
+ * Usage: cout << MSTAlgorithmName(algorithm);
+ * -------------------------------------------
+ * Returns the display name of an algorithm, e.g. "Filter-Kruskal".
+ */
+string MSTAlgorithmName(mstAlgorithmT algorithm);
+
+/*
+ * Function: StringToMSTAlgorithm
+ * Usage: algorithm = StringToMSTAlgorithm("boruvka");
+ * ---------------------------------------------------
+ * Converts the short name used on the command line ("kruskal",
+ * "filter", "boruvka", "prim", "dense-prim" or "auto") to an
+ * algorithm. Raises an error if the name is not recognized.
+ */
+mstAlgorithmT StringToMSTAlgorithm(string name);
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * File: nameindex.cpp
+ * -------------------
+ * Implementation of the NameIndex class declared in nameindex.h.
+ */
+
+#include "nameindex.h"
+#include <cstdlib> // for NULL
+#include <cstring>
+
+
+static const int InitialCapacity = 16;
+
+
+unsigned HashName(const char *start, int length)
+{
+	unsigned hash = 2166136261u;
+	for (int i = 0; i < length; i++) {
+		hash ^= (unsigned char) start[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+
+NameIndex::NameIndex()
+{
+	slots = NULL;
+	capacity = 0;
+	count = 0;
+	names = NULL;
+}
+
+NameIndex::~NameIndex()
+{
+	delete[] slots;
+}
+
+void NameIndex::clear()
+{
+	delete[] slots;
+	slots = NULL;
+	capacity = 0;
+	count = 0;
+	names = NULL;
+}
+
+void NameIndex::reserve(int numNames)
+{
+	int needed = InitialCapacity;
+	while (needed < 2 * numNames) {
+		needed *= 2;
+	}
+	if (needed > capacity) grow(needed);
+}
+
+void NameIndex::setNames(const char *table)
+{
+	names = table;
+}
+
+/* Private member function: findSlot
+ * ---------------------------------
+ * Returns the slot holding the name, or the empty slot where it
+ * would go. Slots are compared on their hash before their characters.
+ */
+int NameIndex::findSlot(const char *start, int length, unsigned hash)
+{
+	int mask = capacity - 1;
+	for (int s = hash & mask; ; s = (s + 1) & mask) {
+		slotT & slot = slots[s];
+		if (slot.id == NameNotFound) return s;
+		if (slot.hash == hash && slot.nameLength == length
+			&& memcmp(names + slot.nameStart, start, length) == 0) return s;
+	}
+}
+
+/* Private member function: grow
+ * -----------------------------
+ * Moves every entry into a table of the new capacity. The stored hash
+ * decides the new position, so no name is hashed again.
+ */
+void NameIndex::grow(int newCapacity)
+{
+	slotT *oldSlots = slots;
+	int oldCapacity = capacity;
+	slots = new slotT[newCapacity];
+	capacity = newCapacity;
+	for (int s = 0; s < capacity; s++) {
+		slots[s].id = NameNotFound;
+	}
+	int mask = capacity - 1;
+	for (int s = 0; s < oldCapacity; s++) {
+		if (oldSlots[s].id == NameNotFound) continue;
+		int t = oldSlots[s].hash & mask;
+		while (slots[t].id != NameNotFound) {
+			t = (t + 1) & mask;
+		}
+		slots[t] = oldSlots[s];
+	}
+	delete[] oldSlots;
+}
+
+void NameIndex::put(int start, int length, int id)
+{
+	if (id < 0) Error("NameIndex::put: ids must not be negative.");
+	if (2 * (count + 1) > capacity) grow(capacity == 0 ? InitialCapacity : 2 * capacity);
+	unsigned hash = HashName(names + start, length);
+	slotT & slot = slots[findSlot(names + start, length, hash)];
+	if (slot.id == NameNotFound) {
+		slot.hash = hash;
+		slot.nameStart = start;
+		slot.nameLength = length;
+		slot.id = id;
+		count++;
+	}
+}
+
+int NameIndex::find(const string & name)
+{
+	return find(name.data(), name.length());
+}
+
+int NameIndex::find(const char *start, int length)
+{
+	if (count == 0) return NameNotFound;
+	return slots[findSlot(start, length, HashName(start, length))].id;
+}
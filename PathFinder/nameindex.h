@@ -0,0 +1,129 @@
+/*
+ * File: nameindex.h
+ * -----------------
+ * An index from names to integer ids, used to turn the city names in
+ * graph files and query files into node ids.
+ */
+
+#ifndef _nameindex_h
+#define _nameindex_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+
+
+/*
+ * Constant: NameNotFound
+ * ----------------------
+ * What NameIndex::find returns for a name that is not in the index.
+ */
+const int NameNotFound = -1;
+
+
+/*
+ * Class: NameIndex
+ * ----------------
+ * An open-addressing hash table with linear probing. The names are
+ * not copied into the index: they stay in a table of characters that
+ * belongs to the caller (such as the graph's name table, which may be
+ * mapped straight from a snapshot), and each slot holds the offset and
+ * length of its name in that table, its id and the full hash of the
+ * name, so most mismatches are rejected without looking at the
+ * characters. The table is kept at most half full, which keeps probe
+ * sequences short; lookups and insertions take O(1) expected time.
+ */
+class NameIndex {
+  public:
+
+	NameIndex();
+	~NameIndex();
+
+	/*
+	 * Member function: clear
+	 * Usage: index.clear();
+	 * ---------------------
+	 * Removes all names from the index.
+	 */
+	void clear();
+
+	/*
+	 * Member function: reserve
+	 * Usage: index.reserve(numCities);
+	 * --------------------------------
+	 * Makes room for the given number of names so that adding that
+	 * many does not make the table grow.
+	 */
+	void reserve(int count);
+
+	/*
+	 * Member function: setNames
+	 * Usage: index.setNames(nameChars);
+	 * ---------------------------------
+	 * Tells the index where the caller's table of names now lies. It
+	 * must be called before the first put, and again whenever the
+	 * table moves; the names already in it must not change.
+	 */
+	void setNames(const char *names);
+
+	/*
+	 * Member function: put
+	 * Usage: index.put(start, length, id);
+	 * ------------------------------------
+	 * Associates the id with the length characters starting at offset
+	 * start in the table given to setNames. If the name is already in
+	 * the index it keeps the id it was first given, so a repeated name
+	 * finds its first occurrence. The id must not be negative.
+	 */
+	void put(int start, int length, int id);
+
+	/*
+	 * Member function: find
+	 * Usage: int id = index.find(name);
+	 * ---------------------------------
+	 * Returns the id associated with the name, or NameNotFound if the
+	 * name is not in the index. The second form looks up the length
+	 * characters starting at start, so a name can be looked up where
+	 * it lies without first copying it into a string.
+	 */
+	int find(const string & name);
+	int find(const char *start, int length);
+
+	int size();
+
+  private:
+	DISALLOW_COPYING(NameIndex)
+
+	struct slotT {
+		unsigned hash;
+		int id;					// NameNotFound if the slot is empty
+		int nameStart;			// offset of the name in names
+		int nameLength;
+	};
+
+	slotT *slots;
+	int capacity;				// always a power of two
+	int count;
+	const char *names;			// the caller's name table
+
+	int findSlot(const char *start, int length, unsigned hash);
+	void grow(int newCapacity);
+};
+
+
+/*
+ * Function: HashName
+ * Usage: unsigned hash = HashName(start, length);
+ * -----------------------------------------------
+ * The 32-bit FNV-1a hash of the characters, which is quick on short
+ * strings such as city names and spreads them well enough for
+ * linear probing.
+ */
+unsigned HashName(const char *start, int length);
+
+
+inline int NameIndex::size()
+{
+	return count;
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * File: options.cpp
+ * -----------------
+ * Implementation of the command-line helpers declared in options.h.
+ */
+
+#include "options.h"
+#include "map.h"
+#include "vector.h"
+#include "strutils.h"
+#include <fstream>
+#ifdef __APPLE__
+#include <crt_externs.h>
+#endif
+
+static Map<string> options;
+
+
+/* Function: GetArguments
+ * ----------------------
+ * Fills args with the words of the command line after the program
+ * name. On the Mac these come from the C runtime; elsewhere they are
+ * read from /proc, where each argument ends with a '\0'.
+ */
+static void GetArguments(Vector<string> & args)
+{
+#ifdef __APPLE__
+	int argc = *_NSGetArgc();
+	char **argv = *_NSGetArgv();
+	for (int i = 1; i < argc; i++) {
+		args.add(argv[i]);
+	}
+#else
+	ifstream in("/proc/self/cmdline");
+	string arg;
+	bool first = true;
+	while (getline(in, arg, '\0')) {
+		if (!first) args.add(arg);
+		first = false;
+	}
+#endif
+}
+
+void InitOptions()
+{
+	Vector<string> args;
+	GetArguments(args);
+	options.clear();
+	for (int i = 0; i < args.size(); i++) {
+		string arg = args[i];
+		if (arg.substr(0, 2) != "--") continue;		// ignore anything the system adds, like -psn_
+		arg = arg.substr(2);
+		string::size_type equals = arg.find('=');
+		if (equals != string::npos) {
+			options[arg.substr(0, equals)] = arg.substr(equals + 1);
+		} else if (i + 1 < args.size() && args[i + 1].substr(0, 2) != "--") {
+			options[arg] = args[i + 1];
+			i++;
+		} else {
+			options[arg] = "true";
+		}
+	}
+}
+
+bool HasOption(string name)
+{
+	return options.containsKey(name);
+}
+
+string GetOption(string name, string defaultValue)
+{
+	string *value = options.find(name);
+	if (value == NULL) return defaultValue;
+	return *value;
+}
+
+int GetIntegerOption(string name, int defaultValue)
+{
+	string *value = options.find(name);
+	if (value == NULL) return defaultValue;
+	return StringToInteger(*value);
+}
@@ -0,0 +1,54 @@
+/*
+ * File: options.h
+ * ---------------
+ * Gives the program access to the flags it was started with, such as
+ *
+ *	PathFinder --threads 8
+ *
+ * The cs106 library supplies the real main and calls our Main without
+ * any arguments on the Mac, so the flags are fetched from the process
+ * instead of being passed down.
+ */
+
+#ifndef _options_h
+#define _options_h
+
+#include "genlib.h"
+
+
+/*
+ * Function: InitOptions
+ * Usage: InitOptions();
+ * ---------------------
+ * Reads the command line of the running program. Flags are written
+ * "--name value" or "--name=value"; a flag with no value is stored
+ * as "true". Call this once at the start of main.
+ */
+void InitOptions();
+
+/*
+ * Function: HasOption
+ * Usage: if (HasOption("threads")) . . .
+ * --------------------------------------
+ * Returns true if the flag was given on the command line.
+ */
+bool HasOption(string name);
+
+/*
+ * Function: GetOption
+ * Usage: algorithm = GetOption("mst", "kruskal");
+ * -----------------------------------------------
+ * Returns the value of the flag, or defaultValue if it was not given.
+ */
+string GetOption(string name, string defaultValue = "");
+
+/*
+ * Function: GetIntegerOption
+ * Usage: threads = GetIntegerOption("threads", 1);
+ * ------------------------------------------------
+ * Returns the value of the flag as an integer, or defaultValue if it
+ * was not given. Raises an error if the value is not an integer.
+ */
+int GetIntegerOption(string name, int defaultValue);
+
+#endif
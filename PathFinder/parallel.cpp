@@ -0,0 +1,40 @@
+/*
+ * File: parallel.cpp
+ * ------------------
+ * Implementation of the thread count settings declared in parallel.h.
+ */
+
+#include "parallel.h"
+#include <unistd.h>
+
+static int threadCount = 0;		// 0 until the first call asks the system
+
+
+int GetThreadCount()
+{
+	if (threadCount == 0) {
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		threadCount = (processors > 0) ? int(processors) : 1;
+	}
+	return threadCount;
+}
+
+void SetThreadCount(int count)
+{
+	if (count < 1) Error("The thread count must be at least 1");
+	threadCount = count;
+}
+
+int ChooseThreadCount(int n, int minPerThread, int numThreads)
+{
+	if (numThreads <= 0) numThreads = GetThreadCount();
+	int useful = n / minPerThread;
+	if (useful < 1) useful = 1;
+	return (numThreads < useful) ? numThreads : useful;
+}
+
+void SplitRange(int n, int thread, int numThreads, int & start, int & end)
+{
+	start = int((long long) n * thread / numThreads);
+	end = int((long long) n * (thread + 1) / numThreads);
+}
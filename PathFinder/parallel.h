@@ -0,0 +1,123 @@
+/*
+ * File: parallel.h
+ * ----------------
+ * A small layer over POSIX threads for running the same function on
+ * several threads at once, each working on its own share of the data.
+ */
+
+#ifndef _parallel_h
+#define _parallel_h
+
+#include "genlib.h"
+#include <pthread.h>
+#include <cstdlib> // for NULL
+
+
+/*
+ * Function: GetThreadCount
+ * Usage: n = GetThreadCount();
+ * ----------------------------
+ * Returns the number of threads the parallel algorithms use. This is
+ * the number of processors unless SetThreadCount has been called
+ * (main calls it with the --threads flag when one is given).
+ */
+int GetThreadCount();
+
+/*
+ * Function: SetThreadCount
+ * Usage: SetThreadCount(4);
+ * -------------------------
+ * Sets the number of threads used from now on. Raises an error if
+ * count is less than 1.
+ */
+void SetThreadCount(int count);
+
+/*
+ * Function: ChooseThreadCount
+ * Usage: numThreads = ChooseThreadCount(n, 16384);
+ * ------------------------------------------------
+ * Returns how many threads are worth starting for n items of work
+ * when each thread should get at least minPerThread items: never more
+ * than numThreads (GetThreadCount() if not given) and never less
+ * than 1.
+ */
+int ChooseThreadCount(int n, int minPerThread, int numThreads = 0);
+
+/*
+ * Function: SplitRange
+ * Usage: SplitRange(n, thread, numThreads, start, end);
+ * -----------------------------------------------------
+ * Divides the indices 0..n-1 into numThreads contiguous pieces of
+ * nearly equal size and sets [start, end) to the piece for thread.
+ */
+void SplitRange(int n, int thread, int numThreads, int & start, int & end);
+
+/*
+ * Function: RunInParallel
+ * Usage: RunInParallel(CountDigits, sortState);
+ *        RunInParallel(CountDigits, sortState, 2);
+ * -----------------------------------------------
+ * Calls fn(thread, numThreads, data) once for every thread index
+ * 0..numThreads-1, each on its own thread, and returns when all of
+ * them have finished. Thread 0 runs on the calling thread. If
+ * numThreads is not given, GetThreadCount() is used. The callback is
+ * responsible for only writing to its own part of data.
+ */
+template <typename ClientDataType>
+void RunInParallel(void (fn)(int thread, int numThreads, ClientDataType & data),
+				   ClientDataType & data, int numThreads = 0);
+
+
+/*
+ * Implementation notes: RunInParallel
+ * -----------------------------------
+ * pthread_create only takes a void * argument, so each thread gets
+ * a parallelTaskT bundling the callback, the client's data and the thread's
+ * index, and RunParallelTask unpacks it on the new thread.
+ */
+
+template <typename ClientDataType>
+struct parallelTaskT {
+	void (*fn)(int, int, ClientDataType &);
+	ClientDataType *data;
+	int thread;
+	int numThreads;
+};
+
+template <typename ClientDataType>
+void *RunParallelTask(void *arg)
+{
+	parallelTaskT<ClientDataType> *task = (parallelTaskT<ClientDataType> *) arg;
+	task->fn(task->thread, task->numThreads, *task->data);
+	return NULL;
+}
+
+template <typename ClientDataType>
+void RunInParallel(void (fn)(int, int, ClientDataType &), ClientDataType & data, int numThreads)
+{
+	if (numThreads <= 0) numThreads = GetThreadCount();
+	if (numThreads == 1) {
+		fn(0, 1, data);
+		return;
+	}
+	parallelTaskT<ClientDataType> *tasks = new parallelTaskT<ClientDataType>[numThreads];
+	pthread_t *threads = new pthread_t[numThreads];
+	for (int i = 0; i < numThreads; i++) {
+		tasks[i].fn = fn;
+		tasks[i].data = &data;
+		tasks[i].thread = i;
+		tasks[i].numThreads = numThreads;
+	}
+	for (int i = 1; i < numThreads; i++) {
+		if (pthread_create(&threads[i], NULL, RunParallelTask<ClientDataType>, &tasks[i]) != 0)
+			Error("Could not start a worker thread");
+	}
+	RunParallelTask<ClientDataType>(&tasks[0]);
+	for (int i = 1; i < numThreads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	delete[] threads;
+	delete[] tasks;
+}
+
+#endif
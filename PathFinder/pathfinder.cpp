@@ -6,15 +6,26 @@
 #include "genlib.h"
 #include "extgraph.h"
 #include <iostream>
-#include <cmath>
 #include "simpio.h"
-#include <fstream>
 #include "strutils.h"
-#include "set.h"
 #include "stack.h"
 #include "vector.h"
 #include "random.h"
-#include "pqueue.h"
+#include "graph.h"
+#include "mst.h"
+#include "parallel.h"
+#include "options.h"
+#include "graphreader.h"
+#include "timer.h"
+#include "spatialindex.h"
+#include "search.h"
+#include "landmarks.h"
+#include "hierarchy.h"
+#include "batch.h"
+#include "matrix.h"
+#include "pathtree.h"
+#include "benchmark.h"
+#include <fstream>
 
 /* Constants
  * --------
@@ -26,43 +37,15 @@ const int LabelFontSize = 9;          // for node name labels
 
 /* Structures
  * ----------
+ * coordT, cityT, arcT and edgeT are shared with the other modules
+ * and are defined in graph.h.
  */
 
-/* Type: coordT
- * ------------
- * Just a simple struct to handle a pair of x,y coordinate values.
- */
-struct coordT {
-	double x, y;
-};
-
-/* Type: arcT
- * ------------
- * A struct to represent an edge between two nodes. Contains
- * the name of each node as well as the distance between them.
- */
-struct arcT {
-	string city1;
-	string city2;
-	int distance;
-};
-
-/* Type: cityT
- * ------------
- * Represents a node on the graph as a city. Contains
- * the name and its location as a coordT.
- */
-
-struct cityT {
-	coordT location;
-	string name;
-};
-
 /* Type: pathT
  * ------------
- * A struct to represent a path to a given node for use
- * in Dijkstra's algorithm. Holds the path as a stack and
- * the cumulative distance.
+ * A struct to represent the path a search found
+ * to a given node. Holds the path as a stack (with the last
+ * city on top) and the cumulative distance.
  */
 
 struct pathT {
@@ -71,75 +54,6 @@ struct pathT {
 };
 
 
-/* Comparison functions to initialize sets
- * --------------------------------------
- */
-
-/* Function: CompareCities
- * -------------------------------------------------------------------
- * Compares two cities, first on their x-coordinates and second on
- * their y-coordinates. Returns 0 if the two cities have the same
- * coordinates.
- */
-
-int CompareCities(cityT city1, cityT city2) {
-	if (city1.location.x > city2.location.x) {
-		return 1;
-	} else if (city1.location.x < city2.location.x) {
-		return -1;
-	} else if (city1.location.y > city2.location.y) {
-		return 1;
-	} else if (city1.location.y < city2.location.y) {
-		return -1;
-	} else {
-		return 0;
-	}
-}
-
-/* Function: CompareArcs
- * -------------------------------------------------------------------
- * Compares two arcs, first on their distance and second on
- * their names. Returns 0 if the arcs are composed of the same
- * two cities.
- */
-
-int CompareArcs(arcT arc1, arcT arc2) {
-	if (arc1.distance < arc2.distance) {
-		return 1;
-	} else if (arc2.distance < arc1.distance) {
-		return -1;
-	} else if (arc1.city1 == arc2.city1 && arc1.city2 == arc2.city2) {
-		return 0;
-	} else if (arc1.city1 == arc2.city2 && arc1.city2 == arc2.city1) {
-		return 0;
-	} else if (arc1.city1 > arc2.city1) {
-		return 1;
-	} else if (arc1.city1 < arc2.city1) {
-		return -1;
-	} else if (arc1.city2 > arc2.city2) {
-		return 1;
-	} else if (arc1.city2 < arc2.city2) {
-		return -1;
-	} else {
-		return 0;
-	}
-}
-
-/* Function: ComparePaths
- * -------------------------------------------------------------------
- * Compares two paths, based on their distance
- */
-
-int ComparePaths(pathT path1, pathT path2) {
-	if (path1.distance < path2.distance) {
-		return 1;
-	} else if (path1.distance > path2.distance) {
-		return -1;
-	} else {
-		return 0;
-	}
-}
-
 /* Graphics Helpers
  * ---------------
  */
@@ -201,75 +115,36 @@ coordT GetMouseClick()
  * -----------------------------------------------
  */
 
-/* Function: WithinDistance
- * Usage:  if (WithinDistance(click, pt))...
- * -----------------------------------------
- * Returns true if the Cartesian distance between the two coordinates
- * is <= the specified distance, false otherwise. If not specified,
- * the distance is assumed to be size of the node diameter on screen.
- */
-bool WithinDistance(coordT pt1, coordT pt2, double maxDistance = CircleRadius*2)
-{
-	double dx = pt2.x - pt1.x;
-	double dy = pt2.y - pt1.y;
-	double distance = sqrt(dx*dx + dy*dy);
-	return (distance <= maxDistance);
-}
-
 /* Function: GetCoord
  * -----------------------------------------
- * Returns the coordinates of a city identified by its name by
- * searching through the set of cities until it finds one with
- * the correct name
- */
-
-coordT GetCoord(string city, Set<cityT> & cities) {
-	Set<cityT>::Iterator it = cities.iterator();
-	while (it.hasNext()) {
-		cityT next = it.next();
-		if (next.name == city) { //if names match, return the coordinates
-			return next.location;
-		}
-	}
-}
-
-/* Function: ConvertToDobule
- * -----------------------------------------
- * Takes two integers that together represent a double 
- * and returns that double. The two integer inputs represent
- * the integers to the left and to the right of a decimal point.
- * The function divides the integer to the right of the decimal by
- * 10 until it is less than 1 before combining the two integers
- * into a double. This was necessitated by the format of the input
- * file.
+ * Looks up the coordinates of a city identified by its name.
+ * Returns true and fills in location if there is such a city,
+ * or returns false, leaving location alone, if there is not.
  */
 
-double ConvertToDouble(int leftOfDecimal, int rightOfDecimal) {
-	double doubleX = rightOfDecimal;
-	while (doubleX >= 1) {
-		doubleX = doubleX / 10.0;
-	}
-	return leftOfDecimal + doubleX;
+bool GetCoord(string city, Graph & graph, coordT & location) {
+	int id = graph.findNode(city);
+	if (id == NoSuchNode) return false;
+	location = graph.getLocation(id);
+	return true;
 }
 
 /* Function: GetMatch
  * -----------------------------------------
- * This function takes a coordT and returns a cityT
- * in the graph with the same coordinates. If there is
- * no city with these coordinates, the function returns
- * a cityT with an empty string as the name. This is used
- * when having the user select two cities with a mouse
- * click to run Dijkstra's algorithm on. 
+ * This function takes a coordT and returns the cityT
+ * in the graph nearest to it, if it is within a node's
+ * diameter. If there is no city that close, the function
+ * returns a cityT with an id of NoSuchNode. This is
+ * used when having the user select two cities with a mouse
+ * click to run Dijkstra's algorithm on. The spatial index
+ * only looks at the cities around the click.
  */
 
-cityT GetMatch(coordT location, Set<cityT> & cities) {
-	Set<cityT>::Iterator it = cities.iterator();
-	while (it.hasNext()) {
-		cityT city = it.next();
-		if (WithinDistance(city.location, location)) return city;
-	}
+cityT GetMatch(coordT location, SpatialIndex & index, Graph & graph) {
+	int id = index.nearestWithin(location, CircleRadius*2);
+	if (id != -1) return graph.getCity(id);
 	cityT toReturn;
-	toReturn.name = "";
+	toReturn.id = NoSuchNode;
 	return toReturn;
 }
 
@@ -277,15 +152,16 @@ cityT GetMatch(coordT location, Set<cityT> & cities) {
  * -----------------------------------------
  * This function takes the name of a city and
  * returns the cityT struct with the same name.
- * It does so by iterating through the set of cities.
+ * If there is no such city, the cityT it returns
+ * has an id of NoSuchNode.
  */
 
-cityT GetNameMatch(string name, Set<cityT> & cities) {
-	Set<cityT>::Iterator it = cities.iterator();
-	while (it.hasNext()) {
-		cityT city = it.next();
-		if (name == city.name) return city;
-	}
+cityT GetNameMatch(string name, Graph & graph) {
+	int id = graph.findNode(name);
+	if (id != NoSuchNode) return graph.getCity(id);
+	cityT toReturn;
+	toReturn.id = NoSuchNode;
+	return toReturn;
 }
 
 
@@ -303,19 +179,32 @@ cityT GetNameMatch(string name, Set<cityT> & cities) {
  * where the user clicked.
  */
 
-cityT GetUserCities(Set<cityT> & cities) {
+cityT GetUserCities(SpatialIndex & index, Graph & graph) {
 	cityT city1;
 	while (true) {
 		cout << "Please click on a city: ";
 		coordT loc1 = GetMouseClick();
-		city1 = GetMatch(loc1, cities);
-		if (city1.name != "") break;
+		city1 = GetMatch(loc1, index, graph);
+		if (city1.id != NoSuchNode) break;
 		cout << "Did not click close enough. Please try again. ";
 	}
-	cout << endl << "You've clicked on: " << city1.name << endl;
+	cout << endl << "You've clicked on: " << graph.getName(city1.id) << endl;
 	return city1;
 }
-/* Function: DrawGraph
+/* Function: ReplaceExtension
+ * -----------------------------------------
+ * Returns the file name with its extension (if it has one) replaced
+ * by the given one, e.g. "USA.txt" and ".graph" give "USA.graph".
+ * This is how the files precomputed for a graph are named.
+ */
+
+string ReplaceExtension(string filename, string extension) {
+	size_t dot = filename.rfind('.');
+	if (dot != string::npos && filename.find('/', dot) == string::npos) filename.erase(dot);
+	return filename + extension;
+}
+
+/* Function: ReadGraphText
  * -----------------------------------------
  * Reads a text file formatted (for example):
  *
@@ -326,358 +215,497 @@ cityT GetUserCities(Set<cityT> & cities) {
  * ARCS
  * Minneapolis WashingtonDC 1600
  *
- * The function takes the data from the file, creating a set
- * of cityT and a set of arcT. It also draws the graph by
- * placing a circle and label at the location of each city.
+ * into the graph. Coordinates and distances may be any real numbers.
+ * Each city is given the next integer id as it is read, and once all
+ * of the arcs are in, the graph's arrays are built.
+ */
+
+void ReadGraphText(GraphReader & in, Graph & graph) {
+	string word;										//reused for every name so reading does not allocate
+	if (!in.readWord(word)) Error("The graph file is empty.");
+	graph.setPictureName(word);							//background image
+	if (!in.readWord(word) || word != "NODES") Error("Expected NODES on line " + IntegerToString(in.lineNumber()));
+	while (true) {
+		if (!in.readWord(word)) Error("Expected ARCS before the end of the graph file.");
+		if (word == "ARCS") break;						//Done with cities
+		coordT location;
+		location.x = in.readReal();
+		location.y = in.readReal();
+		graph.addNode(word, location);					//assign the next node id
+	}
+	
+	//done with NODES, now onto ARCS
+	
+	string City2;
+	while (in.readWord(word)) {
+		if (!in.readWord(City2)) Error("Arc on line " + IntegerToString(in.lineNumber()) + " is missing its second city.");
+		double milesBetween = in.readReal();
+		int id1 = graph.findNode(word);
+		int id2 = graph.findNode(City2);
+		if (id1 == NoSuchNode || id2 == NoSuchNode) {
+			Error("Arc on line " + IntegerToString(in.lineNumber()) + " names a city that is not in the graph.");
+		}
+		graph.addArc(id1, id2, milesBetween);
+	}
+	graph.build();										//lay out the adjacency arrays
+}
+
+/* Function: LoadGraph
+ * -----------------------------------------
+ * Loads a graph from either a text file (see ReadGraphText) or a
+ * binary snapshot written with --convert, which is mapped and used
+ * as it is. Returns false if the file cannot be opened. The text
+ * file is read with a GraphReader, which maps it into memory instead
+ * of going through a stream, and the load time and throughput are
+ * reported.
  */
 
-void DrawGraph(Set<cityT> & cities, Set<arcT> & arcs) {
+bool LoadGraph(string filename, Graph & graph) {
+	double start = CurrentTime();
+	double bytes;
+	if (Graph::IsSnapshotFile(filename)) {
+		graph.loadSnapshot(filename);
+		bytes = 0;										//nothing is read until it is used
+	} else {
+		GraphReader in;
+		if (!in.open(filename)) return false;
+		graph.clear();
+		ReadGraphText(in, graph);
+		bytes = in.fileSize();
+	}
+	double elapsed = CurrentTime() - start;
+	cout << "Loaded " << graph.numNodes() << " cities and " << graph.numArcs() << " arcs";
+	if (bytes == 0) {
+		cout << " from a snapshot in " << elapsed << " seconds" << endl;
+	} else {
+		cout << " (" << bytes / (1024.0 * 1024.0) << " MB) in " << elapsed << " seconds ("
+			 << MegabytesPerSecond(bytes, elapsed) << " MB/s)" << endl;
+	}
+	return true;
+}
+
+/* Function: DrawGraph
+ * -----------------------------------------
+ * Asks the user for a graph file and loads it, then creates the
+ * spatial index used to find clicked cities and draws the graph by
+ * placing a circle and label at the location of each city. Returns
+ * the name of the file that was loaded.
+ */
+
+string DrawGraph(SpatialIndex & index, Graph & graph) {
 	InitGraphics();
-	ifstream in;
 	
 	//get file name from user
+	string FileName;
 	while (true) {
 		cout << "Please enter the name of the input file: ";
-		string FileName = GetLine();
-		in.open(FileName.c_str());
-		if (!in.fail()) break;
+		FileName = GetLine();
+		if (LoadGraph(FileName, graph)) break;
 		cout << "Invalid filename. Please try again." << endl;
-		in.clear();
 	}
 	
-	//start reading data
-	string str;
-	in >> str;
-	DrawNamedPicture(str);				//draw background image
-	in >> str;							//skip "NODES"
-	while (true) {
-		coordT location;
-		cityT city;						//going to add new city to set
-		string NameCity;
-		in >> NameCity;
-		if (NameCity == "ARCS") break;  //Done with cities
-		
-		//convert string coordinates to doubles
-		string xCoordString;			
-		in >> xCoordString;
-		string yCoordString;
-		in >> yCoordString;
-		int xCoord1 = StringToInteger(xCoordString.substr(0,1));
-		int xCoord2 = StringToInteger(xCoordString.substr(2));
-		double xCoord = ConvertToDouble(xCoord1, xCoord2);
-		int yCoord1 = StringToInteger(yCoordString.substr(0,1));
-		int yCoord2 = StringToInteger(yCoordString.substr(2));
-		double yCoord = ConvertToDouble(yCoord1, yCoord2);
-		location.x = xCoord;
-		location.y = yCoord;
-		
-		
-		city.location = location;								
-		city.name = NameCity;									
-		cities.add(city);										//add to set
-		DrawFilledCircleWithLabel(location, "blue", NameCity);  //update picture
-	}
-	
-	//done with NODES, now onto ARCS
-	
-	while (in.peek() != EOF) {
-		arcT arc;     
-		string City1;
-		in >> City1;
-		string City2;
-		in >> City2;
-		if (City1 == "" && City2 == "") break;			//was getting weird behavior where it was reading the last line twice
-		int milesBetween;								//NEED TO EDIT THIS TO HANDLE NON-INTEGER DISTANCES
-		in >> milesBetween;
-		arc.city1 = City1;
-		arc.city2 = City2;
-		arc.distance = milesBetween;
-		arcs.add(arc);									//add arc to set
+	index.build(graph);
+	DrawNamedPicture(graph.getPictureName());			//draw background image
+	for (int id = 0; id < graph.numNodes(); id++) {
+		coordT location = graph.getLocation(id);
+		DrawFilledCircleWithLabel(location, "blue", graph.getName(id));	//update picture
 		
 		//if you wanted to draw all connections of the map, uncomment this:
 		
-//		coordT loc1 = GetCoord(City1, cities); 
-//		coordT loc2 = GetCoord(City2, cities);
-//		DrawLineBetween(loc1, loc2, "red");
-	}	
+//		for (int s = graph.firstSlot(id); s < graph.endSlot(id); s++) {
+//			DrawLineBetween(location, graph.getLocation(graph.targetAt(s)), "red");
+//		}
+	}
+	return FileName;
+}
+
+/* Function: ConvertGraph
+ * -----------------------------------------
+ * Implements --convert: loads a graph file and writes it out as a
+ * snapshot, which later runs can load without any parsing.
+ */
+
+void ConvertGraph(string filename, string snapshotName) {
+	Graph graph;
+	if (!LoadGraph(filename, graph)) Error("Cannot open " + filename);
+	double start = CurrentTime();
+	graph.saveSnapshot(snapshotName);
+	cout << "Wrote the snapshot " << snapshotName << " in " << CurrentTime() - start << " seconds" << endl;
 }
 
 
-/* Part 2: Dijkstra's Algorithm
+/* Part 2: Shortest Paths
  * ---------------------------
+ * The searches themselves (Dijkstra's algorithm and A*) are in
+ * search.h. They work on city ids and return the path as a list of
+ * ids, which is turned into a pathT here for printing and drawing.
  */ 
 
 
-/* Function: GetAllUnseenNeighbors
+/* Function: ChooseSearchAlgorithm
  * -----------------------------------------
- * This function takes a city, the set of arcs in the graph,
- * the set of cities in the graph, and a set of cities that
- * have already been seen. It then returns all of the neighbors
- * of the given city that have not been visited yet. It returns 
- * these neighbors in the form of a vector of arcT, where each arcT
- * will have the city as one node and its neighbor as the other node.
- * The function works by finding each arc in the graph that has
- * the city as one of the nodes and adding it to the vector if the
- * neighbor has not already been seen.
+ * This function asks the user which search to run. Entering 0 picks
+ * the default, which is Dijkstra's algorithm unless another one was
+ * given with the --search flag.
  */
 
-Vector<arcT> GetAllUnseenNeighbors(cityT city, Set<arcT> & arcs, Set<cityT> & seen, Set<cityT> & cities) {
-	Vector<arcT> toReturn;
-	Set<arcT>::Iterator it = arcs.iterator();
-	while (it.hasNext()) {
-		arcT next = it.next();
-		if (next.city1 == city.name) {
-			cityT pair = GetNameMatch(next.city2, cities);		
-			if (!seen.contains(pair)) {						//if the neighbor hasn't been seen, add it to the vector to return
-				toReturn.add(next);
-			}
-		} else if (next.city2 == city.name) {
-			cityT pair = GetNameMatch(next.city1, cities);
-			if (!seen.contains(pair)) {						//if the neighbor hasn't been seen, add it to the vector to return
-				toReturn.add(next);
-			}
-		}
+searchAlgorithmT ChooseSearchAlgorithm(searchAlgorithmT defaultAlgorithm) {
+	cout << "Which search? (0 for " << SearchAlgorithmName(defaultAlgorithm) << ")" << endl;
+	for (int i = 0; i < NumSearchAlgorithms; i++) {
+		cout << "(" << i + 1 << ") " << SearchAlgorithmName(searchAlgorithmT(i)) << endl;
+	}
+	cout << "Search: ";
+	while (true) {
+		int choice = GetInteger();
+		if (choice == 0) return defaultAlgorithm;
+		if (choice > 0 && choice <= NumSearchAlgorithms) return searchAlgorithmT(choice - 1);
+		cout << "Invalid search. Please try again: " << endl;
 	}
-	return toReturn;
 }
 
-/* Function: MakePathsOfNeighbors
+
+/* Function: PrepareLandmarks
  * -----------------------------------------
- * This function takes a path current being examined
- * and a vector of all the unseen neighbors of the current 
- * city (represented in arcTs) and makes updated paths
- * with each of the neighbors. These paths are updated because
- * they will now contain the neighbors, and their distances will
- * be updated to reflect the distance to that city. This distance
- * will be used to prioritize the paths in the priority queue.
- * The function finds the neighbor from each arcT (i.e. the other city)
- * and adds it to the path, updating the distances as it goes.
+ * Makes sure there are landmarks for the graph before an ALT search.
+ * They are read from the .landmarks file next to the graph file if
+ * there is one for this graph; otherwise they are computed (as many
+ * as the --landmarks flag asks for) and saved there for next time.
  */
 
+void PrepareLandmarks(Graph & graph, Landmarks & landmarks, string graphFile) {
+	if (landmarks.size() > 0) return;
+	string filename = ReplaceExtension(graphFile, ".landmarks");
+	double start = CurrentTime();
+	if (landmarks.load(filename, graph)) {
+		cout << "Loaded " << landmarks.size() << " landmarks from " << filename << " in "
+			 << CurrentTime() - start << " seconds" << endl;
+		return;
+	}
+	landmarks.build(graph, GetIntegerOption("landmarks", DefaultLandmarks));
+	cout << "Picked " << landmarks.size() << " landmarks in " << CurrentTime() - start << " seconds" << endl;
+	landmarks.save(filename);
+	cout << "Saved them to " << filename << endl;
+}
 
-void MakePathsOfNeighbors(Vector<arcT> neighbors, pathT currPath, Set<cityT> & cities, Vector<pathT> & toReturn) {
-	cityT currCity = currPath.path.peek();					 //get the city that is neighbors with all the other cities
-	for (int i = 0; i < neighbors.size(); i++) {			 //so that we don't add the same city to the path
-		cityT otherCity;
-		arcT currArc = neighbors[i];
-		if (currArc.city1 == currCity.name) {
-			otherCity = GetNameMatch(currArc.city2, cities); //get the other city based on name
-		} else if (currArc.city2 == currCity.name) {
-			otherCity = GetNameMatch(currArc.city1, cities); //get the other city based on name
-		} else {
-			Error("shouldn't get here because one city should be a match");
-		}
-		cout << "other city is: " << otherCity.name << endl;
-		pathT newPath;											//make a new path with a new stack of cities
-		Stack<cityT> newCities;	
-		newCities = currPath.path;
-		newCities.push(otherCity);								//add the neighbor to the stack of cities
-		double distance = currPath.distance;
-		distance += currArc.distance;							//add the distance of the current edge
-		newPath.path = newCities;
-		newPath.distance = distance;
-		toReturn.add(newPath);									//add the new pathT to a vector that will enqueue each pathT
+
+/* Function: PrepareHierarchy
+ * -----------------------------------------
+ * Makes sure there is a contraction hierarchy for the graph before a
+ * search that uses one, in the same way as PrepareLandmarks: it is
+ * read from the .ch file next to the graph file if there is one for
+ * this graph, and otherwise built and saved there for next time.
+ */
+
+void PrepareHierarchy(Graph & graph, ContractionHierarchy & hierarchy, string graphFile) {
+	if (hierarchy.size() > 0) return;
+	string filename = ReplaceExtension(graphFile, ".ch");
+	double start = CurrentTime();
+	if (hierarchy.load(filename, graph)) {
+		cout << "Loaded the contraction hierarchy from " << filename << " in "
+			 << CurrentTime() - start << " seconds" << endl;
+		return;
 	}
+	hierarchy.build(graph);
+	cout << "Built the contraction hierarchy, adding " << hierarchy.numShortcuts() << " shortcuts, in "
+		 << CurrentTime() - start << " seconds" << endl;
+	hierarchy.save(filename);
+	cout << "Saved it to " << filename << endl;
 }
 
 
-/* Function: Dijkstra
+/* Function: MakePath
  * -----------------------------------------
- * This function takes two cities, a priority queue, 
- * and the set of all edges and nodes in the graph. It
- * then returns a pathT of the shortest path between the 
- * two cities. It does so using Dijkstra's algorithm.
+ * This function builds the pathT that the rest of the program
+ * prints and draws from the ids of the cities a search found:
+ * the source is at the bottom of the stack and the target is on top.
  */
 
-pathT Dijkstra(cityT city1, cityT city2, Set<arcT> & arcs, PQueue<pathT> & pq, Set<cityT> cities) {
-	cout << "city1 is : " << city1.name << endl;
-	cout << "city2 is : " << city2.name << endl;
-	
-	//initialize the search
-	
-	Set<cityT> seen(CompareCities);					//set to make sure we don't get caught in loops
-	cityT currCity;
-	pathT currPath;
-	currCity = city1;								//start at city1
-	Stack<cityT> path;
-	path.push(currCity);							//initialize a path with city1 and distance of 0
-	currPath.path = path;
-	currPath.distance = 0;
-	seen.add(currCity);
-	pq.enqueue(currPath);
-	
-	//loop until the second city is found or all paths are exhausted
-	
-	while (!pq.isEmpty()) {
-		currPath = pq.dequeueMax();
-		currCity = currPath.path.peek();							//current city is the last node in the path so far
-		if (currCity.name == city2.name) return currPath;			//found city2, so return
-		seen.add(currCity);
-		Vector<arcT> neighbors;
-		neighbors = GetAllUnseenNeighbors(currCity, arcs, seen, cities);		//get all unseen neighbors
-		Vector<pathT> neighborsToEnqueue;
-		MakePathsOfNeighbors(neighbors, currPath, cities, neighborsToEnqueue);	//update paths to account for unseen neighbors
-		for (int i = 0; i < neighborsToEnqueue.size(); i++) {
-			pq.enqueue(neighborsToEnqueue[i]);									//enqueue new paths
-		}
+pathT MakePath(searchResultT & result, Graph & graph) {
+	pathT path;
+	path.distance = result.distance;
+	for (int i = 0; i < result.nodes.size(); i++) {
+		path.path.push(graph.getCity(result.nodes[i]));
 	}
-	return currPath;
+	return path;
 }
 
 
-/* Part 3: Kruskal's Algorithm
- * ---------------------------
- */ 
+/* Function: FindShortestPath
+ * -----------------------------------------
+ * This function takes two cities, the graph, a search
+ * algorithm and the landmarks and contraction hierarchy for
+ * the searches that need them. It returns a pathT of the
+ * shortest path between the two cities, and reports how many
+ * cities the search expanded so that the algorithms can be
+ * compared. If there is no path between them, the returned
+ * path is empty.
+ */
+
+pathT FindShortestPath(cityT city1, cityT city2, Graph & graph, searchAlgorithmT algorithm, Landmarks & landmarks,
+					   ContractionHierarchy & hierarchy) {
+	cout << "city1 is : " << graph.getName(city1.id) << endl;
+	cout << "city2 is : " << graph.getName(city2.id) << endl;
+	searchResultT result;
+	double start = CurrentTime();
+	ShortestPath(graph, algorithm, city1.id, city2.id, result, &landmarks, &hierarchy);
+	cout << SearchAlgorithmName(algorithm) << " expanded " << result.expanded << " of "
+		 << graph.numNodes() << " cities in " << CurrentTime() - start << " seconds" << endl;
+	return MakePath(result, graph);
+}
 
 
-/* Function: FindCityInIslandsAndRemove
+/* Function: WriteAnswers
  * -----------------------------------------
- * This function takes a city and a vector of "islands", 
- * where each island represents cities that are connected.
- * The function then finds the island that the city is in and
- * removes that island from the vector of islands (so it can be
- * modified and put back in). The function returns an empty vector 
- * if the city is not in any island (which means that the island it
- * was in was already taken out). 
+ * Writes one line per query, in the order the queries were read: the
+ * two cities and the distance between them, or "none" if there is no
+ * path, followed by the cities along the path if it was kept.
  */
 
-Vector<cityT> FindCityInIslandsAndRemove(cityT city, Vector<Vector<cityT> > & islands) {
-	for (int i = 0; i < islands.size(); i++) {
-		for (int j = 0; j < islands[i].size(); j++) {
-			if (city.name == islands[i][j].name) {
-				Vector<cityT> toReturn;
-				toReturn = islands[i];				//found island, so remove it from the vector of islands and return the island
-				islands.removeAt(i);
-				return toReturn;
-			}
+void WriteAnswers(ostream & out, Graph & graph, Vector<queryT> & queries, searchResultT results[]) {
+	for (int i = 0; i < queries.size(); i++) {
+		out << graph.getName(queries[i].source) << " " << graph.getName(queries[i].target) << " ";
+		if (results[i].found) {
+			out << results[i].distance;
+		} else {
+			out << "none";
+		}
+		for (int j = 0; j < results[i].nodes.size(); j++) {
+			out << " " << graph.getName(results[i].nodes[j]);
 		}
+		out << endl;
 	}
-	Vector<cityT> toReturn;
-	return toReturn;								//didn't find an island with the city in it, so return empty vector
 }
 
 
-/* Function: Union
+/* Function: RunBatch
  * -----------------------------------------
- * This function takes two vectors of cityT (representing "islands")
- * and unions the two islands. The function takes advantage of the
- * set class, adding each island to a seperate set, unioning the two sets,
- * and then returning the result in the form of a vector.
- *
- * The reason the islands are not initially represented as sets is because
- * I could not figure out a way to have another container class that had sets in 
- * it (i.e. a vector of sets).
+ * Implements --batch: loads the graph given with --graph, answers
+ * every query in the query file with the search given with --search
+ * (see batch.h), and writes the answers to the --output file, or to
+ * the console if there is none. --paths asks for the cities along
+ * each path as well as the distance. The time the queries took and
+ * the number answered per second are reported at the end.
  */
-Vector<cityT> Union(Vector<cityT> & set1, Vector<cityT> & set2) {
-	Set<cityT> RealSet1(CompareCities);				//make Sets to hold contents of vectors
-	Set<cityT> RealSet2(CompareCities);
-	Vector<cityT> toReturn;
-	for (int i = 0; i < set1.size(); i++) {			//add contents of each vector to its corresponding set
-		RealSet1.add(set1[i]);
+
+void RunBatch(string queryFile, searchAlgorithmT algorithm) {
+	if (!HasOption("graph")) Error("--batch needs the graph to search, given with --graph");
+	string graphFile = GetOption("graph");
+	Graph graph;
+	Landmarks landmarks;
+	ContractionHierarchy hierarchy;
+	if (!LoadGraph(graphFile, graph)) Error("Cannot open " + graphFile);
+	if (algorithm == ALTSearch) PrepareLandmarks(graph, landmarks, graphFile);
+	if (algorithm == CHSearch) PrepareHierarchy(graph, hierarchy, graphFile);
+	Vector<queryT> queries;
+	ReadQueries(queryFile, graph, queries);
+
+	searchResultT *results = new searchResultT[queries.size()];
+	double start = CurrentTime();
+	int numThreads = RunQueries(graph, algorithm, queries, results, &landmarks, &hierarchy, HasOption("paths"));
+	double elapsed = CurrentTime() - start;
+	if (HasOption("output")) {
+		string filename = GetOption("output");
+		ofstream out(filename.c_str());
+		if (out.fail()) Error("Cannot write the answers to " + filename);
+		WriteAnswers(out, graph, queries, results);
+		out.close();
+		if (out.fail()) Error("Cannot write the answers to " + filename);
+	} else {
+		WriteAnswers(cout, graph, queries, results);
 	}
-	for (int i = 0; i < set2.size(); i++) {
-		RealSet2.add(set2[i]);
+	cout << SearchAlgorithmName(algorithm) << " answered " << queries.size() << " queries in " << elapsed
+		 << " seconds on " << numThreads << " threads";
+	if (elapsed > 0) cout << " (" << queries.size() / elapsed << " queries per second)";
+	cout << endl;
+	delete[] results;
+}
+
+
+/* Function: ComputeDistanceMatrix
+ * -----------------------------------------
+ * Asks for a file of source cities, a file of target cities (the
+ * sources again if it is left blank) and a file to write to, and
+ * writes the distance from every source to every target in the graph
+ * that is loaded (see matrix.h): as comma-separated text if the file
+ * name ends in .csv, and in the binary matrix format otherwise.
+ */
+
+void ComputeDistanceMatrix(Graph & graph) {
+	Vector<int> sources, targets;
+	while (true) {
+		cout << "Please enter the name of the file listing the source cities: ";
+		if (ReadCityList(GetLine(), graph, sources)) break;
+		cout << "Invalid filename. Please try again." << endl;
+	}
+	while (true) {
+		cout << "Please enter the name of the file listing the target cities (blank for the same cities): ";
+		string filename = GetLine();
+		if (filename == "") {
+			targets = sources;
+			break;
+		}
+		if (ReadCityList(filename, graph, targets)) break;
+		cout << "Invalid filename. Please try again." << endl;
 	}
-	RealSet1.unionWith(RealSet2);					//union sets
-	Set<cityT>::Iterator it = RealSet1.iterator();
-	while (it.hasNext()) {
-		toReturn.add(it.next());					//put contents of unioned set into a vector to return it
+	cout << "Please enter the name of the file to write the matrix to: ";
+	string outputFile = GetLine();
+
+	double *matrix = new double[size_t(sources.size()) * targets.size()];
+	double start = CurrentTime();
+	DistanceMatrix(graph, sources, targets, matrix);
+	cout << "Found the distances from " << sources.size() << " cities to " << targets.size() << " cities in "
+		 << CurrentTime() - start << " seconds" << endl;
+	string extension = (outputFile.length() >= 4) ? ConvertToLowerCase(outputFile.substr(outputFile.length() - 4)) : "";
+	if (extension == ".csv") {
+		WriteMatrixText(outputFile, graph, sources, targets, matrix);
+	} else {
+		WriteMatrixBinary(outputFile, sources, targets, matrix);
 	}
-	return toReturn;
+	cout << "Wrote the matrix to " << outputFile << endl;
+	delete[] matrix;
 }
-	
 
-/* Function: Kruskal
+
+/* Function: ShowPathTree
  * -----------------------------------------
- * This function takes a graph represented by its
- * nodes and edges and a vector of edges to populate.
- * It then populates that vector of edges with the edges
- * needed to span the whole graph with minimal cost.
- * It does so using Kruskal's algorithm.
+ * Asks the user to click on a city and finds the shortest paths from
+ * it to every other city in one search (ShortestPathTree in search.h).
+ * The tree can then be written to a file (see pathtree.h) and drawn,
+ * each city joined to the one before it on its path.
  */
 
-void Kruskal(Set<cityT> & cities, Set<arcT> & arcs, Vector<arcT> & toReturn) {
-	
-	//initialize containers
-	Vector<cityT> toSee;
-	PQueue<arcT> pq(CompareArcs);
-	Vector<Vector<cityT> > islands;					//each island is a vector of cityT, and these islands are contained in a vector
-	
-	//populate toSee, islands
-	Set<cityT>::Iterator it = cities.iterator();	//to start, each node is in its own island (alone)
-	while (it.hasNext()) { 
-		cityT next = it.next();
-		Vector<cityT> island;
-		island.add(next);
-		islands.add(island);
-		toSee.add(next);
+void ShowPathTree(SpatialIndex & index, Graph & graph) {
+	cityT source = GetUserCities(index, graph);
+	int numCities = graph.numNodes();
+	double *distance = new double[numCities];
+	int *parent = new int[numCities];
+	double start = CurrentTime();
+	ShortestPathTree(graph, source.id, distance, parent);
+	double elapsed = CurrentTime() - start;
+	int reached = 0;
+	for (int id = 0; id < numCities; id++) {
+		if (parent[id] != -1) reached++;
 	}
-
-	//populate priority queue of arcs
-	Set<arcT>::Iterator it2 = arcs.iterator();		
-	while (it2.hasNext()) { 
-		pq.enqueue(it2.next());
+	cout << "Found the paths from " << graph.getName(source.id) << " to " << reached << " of " << numCities
+		 << " cities in " << elapsed << " seconds" << endl;
+
+	cout << "Please enter the name of the file to write the tree to (blank for none): ";
+	string filename = GetLine();
+	if (filename != "") {
+		WritePathTree(filename, graph, source.id, distance, parent);
+		cout << "Wrote the tree to " << filename << endl;
 	}
-	
-	//loop until there are enough edges to connect the whole graph
-	while (toReturn.size() < toSee.size() - 1) { 
-		arcT toExamine = pq.dequeueMax();
-		cityT city1 = GetNameMatch(toExamine.city1, cities);					//get each city from the current edge
-		cityT city2 = GetNameMatch(toExamine.city2, cities);
-		Vector<cityT> setOfCity1 = FindCityInIslandsAndRemove(city1, islands);	//get the island containing each city in the current edge
-		Vector<cityT> setOfCity2 = FindCityInIslandsAndRemove(city2, islands);
-
-		//cases:
-		
-		if (setOfCity1.size() == 1 && setOfCity2.size() == 1) {					//neither city is connected to any other cities
-			setOfCity1.add(city2);
-			islands.add(setOfCity1);											//put both cities in same island and add current edge to toReturn
-			toReturn.add(toExamine);
-			
-		} else if (setOfCity1.size() == 1) {									//city1 is unconnected, so add it to the island of city2
-			setOfCity2.add(city1);
-			islands.add(setOfCity2);
-			toReturn.add(toExamine);
-			
-		} else if (setOfCity2.size() == 1) {									//city2 is unconnected, so add it to the island of city1
-			setOfCity1.add(city2);
-			islands.add(setOfCity1);
-			toReturn.add(toExamine);
-			
-		} else if (setOfCity1.size() == 0 || setOfCity2.size() == 0) {			//the cities are in the same island, so put the island back in the vector and continue
-			if (setOfCity1.size() == 0) islands.add(setOfCity2);
-			if (setOfCity2.size() == 0) islands.add(setOfCity1);
-			continue;
-			
-		} else {																//the cities are in different islands, so union the two islands
-			Vector<cityT> unionedSet = Union(setOfCity1, setOfCity2);
-			islands.add(unionedSet);
-			toReturn.add(toExamine);
+	cout << "Draw the tree? (y/n): ";
+	string answer = GetLine();
+	if (answer != "" && (answer[0] == 'y' || answer[0] == 'Y')) {
+		for (int id = 0; id < numCities; id++) {
+			if (parent[id] == -1 || parent[id] == id) continue;
+			DrawLineBetween(graph.getLocation(parent[id]), graph.getLocation(id), "red");
 		}
 	}
-	for (int i = 0; i < toReturn.size(); i++) {									//draw connections on graph
-		DrawLineBetween(GetNameMatch(toReturn[i].city1, cities).location, GetNameMatch(toReturn[i].city2, cities).location, "red");
+	delete[] distance;
+	delete[] parent;
+}
+
+
+/* Part 3: Minimum Spanning Trees
+ * ------------------------------
+ * The spanning tree itself is computed by one of the algorithms in
+ * mst.h (Kruskal's, Filter-Kruskal, Boruvka's or Prim's, or one picked
+ * automatically). This part lets the user pick one and draws the result.
+ */ 
+
+
+/* Function: ChooseMSTAlgorithm
+ * -----------------------------------------
+ * This function asks the user which spanning tree algorithm to run.
+ * Entering 0 picks the default, which is Kruskal's algorithm unless
+ * another one was given with the --mst flag.
+ */
+
+mstAlgorithmT ChooseMSTAlgorithm(mstAlgorithmT defaultAlgorithm) {
+	cout << "Which algorithm? (0 for " << MSTAlgorithmName(defaultAlgorithm) << ")" << endl;
+	for (int i = 0; i < NumMSTAlgorithms; i++) {
+		cout << "(" << i + 1 << ") " << MSTAlgorithmName(mstAlgorithmT(i)) << endl;
+	}
+	cout << "Algorithm: ";
+	while (true) {
+		int choice = GetInteger();
+		if (choice == 0) return defaultAlgorithm;
+		if (choice > 0 && choice <= NumMSTAlgorithms) return mstAlgorithmT(choice - 1);
+		cout << "Invalid algorithm. Please try again: " << endl;
+	}
+}
+
+
+/* Function: MinimumSpanningTree
+ * -----------------------------------------
+ * This function takes the graph, an algorithm and a vector of edges
+ * to populate. It then populates that vector of edges with the edges
+ * needed to span the whole graph with minimal cost, draws them, and
+ * reports the total length. Every algorithm finds the same total
+ * length, although with ties they may pick different edges.
+ */
+
+void MinimumSpanningTree(Graph & graph, mstAlgorithmT algorithm, Vector<arcT> & toReturn) {
+	if (algorithm == AutoMST) {
+		algorithm = PickMSTAlgorithm(graph);
+		cout << "With " << graph.numArcs() << " arcs between " << graph.numNodes() << " cities, using "
+			 << MSTAlgorithmName(algorithm) << endl;
 	}
+	Vector<edgeT> tree;
+	double length = SpanningTree(graph, algorithm, tree);
+	for (int i = 0; i < tree.size(); i++) {
+		arcT arc;
+		arc.city1 = tree[i].from;
+		arc.city2 = tree[i].to;
+		arc.distance = tree[i].distance;
+		toReturn.add(arc);
+		DrawLineBetween(graph.getLocation(tree[i].from), graph.getLocation(tree[i].to), "red");	//draw connection on graph
+	}
+	cout << MSTAlgorithmName(algorithm) << " found " << tree.size() << " edges with a total length of "
+		 << length << endl;
 }
 
 
 /* Part 4: Main
  * ---------------------------
  * The main function initializes the containers and deals with the UI. 
- * It prompts the user to select from four options: 1) choosing a new
- * file to get the graph data from, 2) using dijkstra's algorithm
- * on two cities, 3) using Kruskal's algorithm to find the minimum spanning
- * tree and 4) qutting.
+ * It prompts the user to select from six options: 1) choosing a new
+ * file to get the graph data from, 2) finding the shortest path
+ * between two cities with the search of their choice, 3) finding the
+ * minimum spanning tree with the algorithm of their choice, 4) writing
+ * the table of distances between two lists of cities, 5) finding the
+ * shortest paths from one city to all of the others and 6) qutting.
  */ 
 
 int main()
 {
 	//initialize containers
 	
-	PQueue<pathT> pq(ComparePaths);
-	Set<cityT> cities(CompareCities);
-	Set<arcT> arcs(CompareArcs);
+	Graph graph;
+	SpatialIndex index;
+	Landmarks landmarks;
+	ContractionHierarchy hierarchy;
+	string graphFile;
 	SetWindowTitle("Pathfinder");
+	InitOptions();
+	if (HasOption("threads")) SetThreadCount(GetIntegerOption("threads", 1));
+	mstAlgorithmT defaultMST = StringToMSTAlgorithm(GetOption("mst", "kruskal"));
+	searchAlgorithmT defaultSearch = StringToSearchAlgorithm(GetOption("search", "dijkstra"));
+	if (HasOption("convert")) {
+		string filename = GetOption("convert");
+		ConvertGraph(filename, GetOption("output", ReplaceExtension(filename, ".graph")));
+		return (0);
+	}
+	if (HasOption("batch")) {
+		RunBatch(GetOption("batch"), defaultSearch);
+		return (0);
+	}
+	if (HasOption("benchmark")) {
+		RunBenchmark(GetOption("benchmark"));
+		return (0);
+	}
 	
 	//give info to user
     cout << "This program presents a lovely visual presentation of a graph" << endl
@@ -687,45 +715,60 @@ int main()
 	while (true) {
 		cout << "Please select an option: " << endl;
 		cout << "(1) Choose a new graph data file" << endl;
-		cout << "(2) Find shortest path using Dijkstra's algorithm" << endl;
-		cout << "(3) Find minimum spanning tree using Kruskal's algorithm" << endl;
-		cout << "(4) Quit" << endl;
+		cout << "(2) Find shortest path (Dijkstra's algorithm, A*, bidirectional, ALT or CH)" << endl;
+		cout << "(3) Find minimum spanning tree (Kruskal, Filter-Kruskal, Boruvka or Prim)" << endl;
+		cout << "(4) Distance matrix between lists of cities" << endl;
+		cout << "(5) Shortest path tree from one city" << endl;
+		cout << "(6) Quit" << endl;
 		cout << "Option: ";
 		int option;
 		
 		//get selection from user
 		while (true) {
 			option = GetInteger();
-			if (option > 0 && option < 5) break;
+			if (option > 0 && option < 7) break;
 			cout << "Invalid option. Please try again: " << endl;
 		}
 		if (option == 1) {							//input data from graph file
-			DrawGraph(cities, arcs);
-		} else if (option == 2) {					//Dijsktra:
+			graphFile = DrawGraph(index, graph);
+			landmarks.clear();						//they belonged to the old graph
+			hierarchy.clear();
+		} else if (option == 2) {					//Shortest path:
 			
 			//get cities
-			cityT city1 = GetUserCities(cities);	
-			cityT city2 = GetUserCities(cities);
+			cityT city1 = GetUserCities(index, graph);
+			cityT city2 = GetUserCities(index, graph);
 			
-			//run Dijkstra
-			pathT path = Dijkstra(city1, city2, arcs, pq, cities);
+			//run the search
+			searchAlgorithmT algorithm = ChooseSearchAlgorithm(defaultSearch);
+			if (algorithm == ALTSearch) PrepareLandmarks(graph, landmarks, graphFile);
+			if (algorithm == CHSearch) PrepareHierarchy(graph, hierarchy, graphFile);
+			pathT path = FindShortestPath(city1, city2, graph, algorithm, landmarks, hierarchy);
 			
 			//draw path on graph and output the path as text
+			if (path.path.isEmpty()) {
+				cout << "There is no path between the two cities." << endl;
+				continue;
+			}
 			cout << "The two cities are " << path.distance << " far apart" << endl;
 			cout << "This is the backwards path between them: ";
 			if (!path.path.isEmpty()) {
 					cityT city = path.path.pop();
-				cout << city.name << endl;
+				cout << graph.getName(city.id) << endl;
 					while (!path.path.isEmpty()) {
 						cityT city2 = path.path.pop();
 						DrawLineBetween(city.location, city2.location, "red");
 						city = city2;
-						cout << city2.name << endl;
+						cout << graph.getName(city2.id) << endl;
 					}
 			}
-		} else if (option == 3) {				//Kruskal
+		} else if (option == 3) {				//Spanning tree
 			Vector<arcT> toReturn;
-			Kruskal(cities, arcs, toReturn);
+			MinimumSpanningTree(graph, ChooseMSTAlgorithm(defaultMST), toReturn);
+		} else if (option == 4) {				//Distance matrix
+			ComputeDistanceMatrix(graph);
+		} else if (option == 5) {				//Shortest path tree
+			ShowPathTree(index, graph);
 		} else {								//Quit
 			break;
 		}
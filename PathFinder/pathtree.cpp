@@ -0,0 +1,54 @@
+/*
+ * File: pathtree.cpp
+ * ------------------
+ * Implementation of the shortest path tree files declared in
+ * pathtree.h.
+ */
+
+#include "pathtree.h"
+#include <cstring>
+#include <fstream>
+
+
+/* Tree file format
+ * ----------------
+ * A treeHeaderT, then double distance[numNodes] and int
+ * parent[numNodes], in city id order. A city that cannot be reached
+ * has distance NoDistance (IEEE infinity) and parent -1, and the
+ * source is its own parent. The distances come first so that both
+ * arrays are aligned to their size. As with graph snapshots, the
+ * byte order mark tells a reader on a machine of the other byte order
+ * to swap, and any change to the layout must bump TreeVersion.
+ */
+
+static const char TreeMagic[8] = "PFTREE";
+static const int TreeVersion = 1;
+static const int TreeByteOrder = 0x01020304;
+
+struct treeHeaderT {
+	char magic[8];
+	int version;
+	int byteOrder;
+	int numNodes;
+	int source;
+};
+
+
+void WritePathTree(string filename, Graph & graph, int source, double distance[], int parent[])
+{
+	treeHeaderT header;
+	memset(&header, 0, sizeof header);
+	memcpy(header.magic, TreeMagic, sizeof header.magic);
+	header.version = TreeVersion;
+	header.byteOrder = TreeByteOrder;
+	header.numNodes = graph.numNodes();
+	header.source = source;
+
+	ofstream out(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if (out.fail()) Error("Cannot write the shortest path tree " + filename);
+	out.write((const char *) &header, sizeof header);
+	out.write((const char *) distance, size_t(header.numNodes) * sizeof(double));
+	out.write((const char *) parent, size_t(header.numNodes) * sizeof(int));
+	out.close();
+	if (out.fail()) Error("Cannot write the shortest path tree " + filename);
+}
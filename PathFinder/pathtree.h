@@ -0,0 +1,29 @@
+/*
+ * File: pathtree.h
+ * ----------------
+ * Saving a shortest path tree, as computed by ShortestPathTree in
+ * search.h, to a file: the distance from the source to every city
+ * and the city before it on the way there, as flat arrays indexed by
+ * city id. Another program can read the whole tree with two reads,
+ * and find any city's path by following the parents to the source.
+ */
+
+#ifndef _pathtree_h
+#define _pathtree_h
+
+#include "genlib.h"
+#include "graph.h"
+
+
+/*
+ * Function: WritePathTree
+ * Usage: WritePathTree("Boston.tree", graph, source, distance, parent);
+ * ---------------------------------------------------------------------
+ * Writes the tree from source in the format described in pathtree.cpp.
+ * distance and parent have numNodes() entries each, filled in as
+ * ShortestPathTree fills them. Raises an error if the file cannot be
+ * written.
+ */
+void WritePathTree(string filename, Graph & graph, int source, double distance[], int parent[]);
+
+#endif
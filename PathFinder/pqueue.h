@@ -14,17 +14,29 @@
 #include "vector.h"
 #include "disallowcopy.h"
 #include "cmpfn.h"
+#include "strutils.h"
 #include <iostream>
 
 
+/*
+ * Constant: DefaultHeapArity
+ * --------------------------
+ * The number of children per heap node used when the client does
+ * not ask for a particular arity. A 4-ary heap keeps the children of
+ * a node close together in memory and halves the depth of the tree
+ * compared to a binary heap.
+ */
+const int DefaultHeapArity = 4;
+
+
 /*
  * Class: PQueue
  * -------------
  * This is the class for a priority queue.  This is not
  * simple FIFO queue, it is a priority queue, where elements are
  * retrieved in order of priority, not just by longevity in queue.
- * The elements are integers and the integer is assumed to represent 
- * the priority (larger integer is higher priority).
+ * The comparison function determines the priority: the element
+ * that compares largest is the one dequeued first.
  */
 template <typename ElemType>
 class PQueue 
@@ -34,11 +46,16 @@ class PQueue
 	/*
 	 * Constructor: PQueue
 	 * Usage: PQueue pq;
+	 *        PQueue pq(ComparePaths, 2);
 	 *        PQueue *ppq = new PQueue;
 	 * ---------------------------------
-	 * Initializes a new pqueue to have no elements.  
+	 * Initializes a new pqueue to have no elements. The optional
+	 * second argument is the arity of the underlying heap (the number
+	 * of children per node). Wider heaps are shallower, so enqueue
+	 * does fewer moves at the cost of more comparisons per level in
+	 * dequeueMax. It must be at least 2 and defaults to 4.
 	 */
-	PQueue(int (cmpFn)(ElemType, ElemType) = OperatorCmp);
+	PQueue(int (cmpFn)(ElemType, ElemType) = OperatorCmp, int arity = DefaultHeapArity);
 
 
 	/*
@@ -73,7 +90,7 @@ class PQueue
 	 * Usage: pq.enqueue(val);
 	 * -----------------------
 	 * Adds the specified element to this pqueue. No effort is made to
-	 * avoid duplicates. 
+	 * avoid duplicates. Runs in O(log n).
 	 */
 	void enqueue(ElemType newElem);
 
@@ -83,11 +100,31 @@ class PQueue
 	 * Usage: maxElem = pq.dequeueMax();
 	 * ---------------------------------
 	 * Removes the largest priority element from this pqueue and returns it.
-	 * If this pqueue is empty, this function raises an error.
+	 * If this pqueue is empty, this function raises an error. Runs in
+	 * O(log n).
 	 */
 	ElemType dequeueMax();
 
 
+	/*
+	 * Member function: peekMax
+	 * Usage: maxElem = pq.peekMax();
+	 * ------------------------------
+	 * Returns the largest priority element without removing it.
+	 * If this pqueue is empty, this function raises an error.
+	 */
+	ElemType peekMax();
+
+
+	/*
+	 * Member function: clear
+	 * Usage: pq.clear();
+	 * ------------------
+	 * Removes all elements from this pqueue.
+	 */
+	void clear();
+
+
 	/*
 	 * Member function: bytesUsed
 	 * Usage: numBytes = pq.bytesUsed();
@@ -135,35 +172,167 @@ class PQueue
 	// a precaution
 	DISALLOW_COPYING(PQueue)
 	int (*cmpFn)(ElemType, ElemType);
+	int arity;
 
-  	/* This is the representation for the unsorted vector.
-  	 * You will need to update this as you change representations. */
+  	/* The entries form a d-ary heap stored level by level: the
+  	 * children of entries[i] are entries[arity*i + 1 .. arity*i + arity]. */
 	Vector<ElemType> entries;
 
+	void siftUp(int index);
+	void siftDown(int index);
 };
 
 
 /*
- * File: pqvector.cpp
- * ------------------
- * This file implements the priority queue class as a vector
- * of integers stored in no particular order.  This makes it easy
- * enqueue new elements, but hard to dequeue the max (have to search for it).
- *
- * Julie Zelenski, CS106
+ * Class: IndexedPQueue
+ * --------------------
+ * A priority queue over the integer ids 0..capacity-1 where each id
+ * is in the queue at most once together with a key. Unlike PQueue,
+ * the id with the _smallest_ key comes out first, and the key of an
+ * id that is already enqueued can be lowered in place with
+ * decreaseKey. This is the queue a shortest-path search wants: one
+ * entry per node, whose distance only ever goes down.
  */
+template <typename KeyType>
+class IndexedPQueue
+{
+  public:
+
+	/*
+	 * Constructor: IndexedPQueue
+	 * Usage: IndexedPQueue<double> pq(graph.numNodes());
+	 * --------------------------------------------------
+	 * Initializes an empty queue that can hold the ids 0..capacity-1.
+	 * The comparison function orders the keys and the arity sets the
+	 * shape of the heap as for PQueue.
+	 */
+	IndexedPQueue(int capacity, int (cmpFn)(KeyType, KeyType) = OperatorCmp,
+				  int arity = DefaultHeapArity);
+
+	~IndexedPQueue();
+
+	bool isEmpty();
+	int size();
+
+	/*
+	 * Member function: capacity
+	 * Usage: n = pq.capacity();
+	 * -------------------------
+	 * Returns one more than the largest id this queue can hold.
+	 */
+	int capacity();
+
+	/*
+	 * Member function: contains
+	 * Usage: if (pq.contains(id)) . . .
+	 * ---------------------------------
+	 * Returns true if the id is currently in this queue.
+	 */
+	bool contains(int id);
+
+	/*
+	 * Member function: enqueue
+	 * Usage: pq.enqueue(id, key);
+	 * ---------------------------
+	 * Adds the id with the given key. Raises an error if the id is
+	 * out of range or is already in this queue.
+	 */
+	void enqueue(int id, KeyType key);
+
+	/*
+	 * Member function: decreaseKey
+	 * Usage: pq.decreaseKey(id, smallerKey);
+	 * --------------------------------------
+	 * Replaces the key of an id that is already in this queue with a
+	 * key that is no larger and restores the heap order. Runs in
+	 * O(log n). Raises an error if the id is not in this queue.
+	 */
+	void decreaseKey(int id, KeyType key);
 
-/* Implementation notes: PQueue class
+	/*
+	 * Member function: changeKey
+	 * Usage: pq.changeKey(id, newKey);
+	 * --------------------------------
+	 * Replaces the key of an id that is already in this queue with any
+	 * key, larger or smaller, and restores the heap order. Runs in
+	 * O(log n). Raises an error if the id is not in this queue.
+	 */
+	void changeKey(int id, KeyType key);
+
+	/*
+	 * Member function: getKey
+	 * Usage: key = pq.getKey(id);
+	 * ---------------------------
+	 * Returns the key of an id that is in this queue.
+	 */
+	KeyType getKey(int id);
+
+	/*
+	 * Member function: peekMin
+	 * Usage: id = pq.peekMin();
+	 * -------------------------
+	 * Returns the id with the smallest key without removing it.
+	 */
+	int peekMin();
+
+	/*
+	 * Member function: dequeueMin
+	 * Usage: id = pq.dequeueMin();
+	 * ----------------------------
+	 * Removes the id with the smallest key and returns it. Raises an
+	 * error if this queue is empty.
+	 */
+	int dequeueMin();
+
+	/*
+	 * Member function: clear
+	 * Usage: pq.clear();
+	 * ------------------
+	 * Removes every id from this queue. This only touches the ids
+	 * that are still enqueued, not the whole capacity.
+	 */
+	void clear();
+
+	int bytesUsed();
+	string implementationName();
+
+  private:
+	DISALLOW_COPYING(IndexedPQueue)
+	int (*cmpFn)(KeyType, KeyType);
+	int arity;
+	int numIds;
+
+	/* heap holds the ids in d-ary heap order, keys[id] is the key of
+	 * the id and position[id] is its index in heap (-1 if absent). */
+	Vector<int> heap;
+	KeyType *keys;
+	int *position;
+
+	void checkId(int id, const char *verb);
+	void siftUp(int index);
+	void siftDown(int index);
+};
+
+
+/*
+ * Implementation notes: PQueue class
  * ----------------------------------
- * The private section for the pqvector looks like this:
- *
- *	Vector<int> entries;
+ * The pqueue is kept as a d-ary max-heap in a vector. The largest
+ * element is always entries[0], the parent of entries[i] is
+ * entries[(i-1)/arity], and every parent compares at least as large
+ * as its children. enqueue appends at the end and sifts the new
+ * element up; dequeueMax moves the last element into the root and
+ * sifts it down. Both only touch one path of the tree, so both run
+ * in O(log n), and removing the last vector element never shifts
+ * anything.
  */
 
 template <typename ElemType>
-PQueue<ElemType>::PQueue(int (cmp)(ElemType, ElemType))
+PQueue<ElemType>::PQueue(int (cmp)(ElemType, ElemType), int heapArity)
 {
+	if (heapArity < 2) Error("PQueue arity must be at least 2");
 	cmpFn = cmp;
+	arity = heapArity;
 }
 
 template <typename ElemType>
@@ -183,53 +352,95 @@ int PQueue<ElemType>::size()
 	return (entries.size());
 }
 
-
-/* Implementation notes: enqueue
- * -----------------------------
- * Since we're keeping the vector in no particular order, we just append this
- * new element to the end.  It's the easiest/fastest thing to do.
- */
 template <typename ElemType>
 void PQueue<ElemType>::enqueue(ElemType newValue)
 {
 	entries.add(newValue);
+	siftUp(entries.size() - 1);
 }
 
-
-/* Implementation notes: dequeueMax
- * --------------------------------
- * Since we're keeping the vector in no particular order, we have to search to
- * find the largest element.  Once found, we remove it from the vector and
- * return that value.
- */
 template <typename ElemType>
 ElemType PQueue<ElemType>::dequeueMax()
 {	
 	if (isEmpty())
 		Error("Tried to dequeue max from an empty pqueue!");
 	
-	int maxIndex = 0;	// assume first element is largest until proven otherwise
 	ElemType maxValue = entries[0];
-	for (int i = 1; i < entries.size(); i++) {
-		if (cmpFn(entries[i], maxValue) == 1) {
-			maxValue = entries[i];
-			maxIndex = i;
+	int last = entries.size() - 1;
+	if (last > 0) entries[0] = entries[last];
+	entries.removeAt(last);		// removing the last entry shifts nothing
+	if (last > 0) siftDown(0);
+	return maxValue;
+}
+
+template <typename ElemType>
+ElemType PQueue<ElemType>::peekMax()
+{
+	if (isEmpty())
+		Error("Tried to peek at max of an empty pqueue!");
+	return entries[0];
+}
+
+template <typename ElemType>
+void PQueue<ElemType>::clear()
+{
+	entries.clear();
+}
+
+/* Private member function: siftUp
+ * -------------------------------
+ * Moves the element at index toward the root until its parent
+ * compares at least as large. The element is held aside and the
+ * parents slide down into the hole, so each level costs one copy.
+ */
+template <typename ElemType>
+void PQueue<ElemType>::siftUp(int index)
+{
+	ElemType value = entries[index];
+	while (index > 0) {
+		int parent = (index - 1) / arity;
+		if (cmpFn(value, entries[parent]) <= 0) break;
+		entries[index] = entries[parent];
+		index = parent;
+	}
+	entries[index] = value;
+}
+
+/* Private member function: siftDown
+ * ---------------------------------
+ * Moves the element at index away from the root, swapping places
+ * with the largest of its children, until no child is larger.
+ */
+template <typename ElemType>
+void PQueue<ElemType>::siftDown(int index)
+{
+	int n = entries.size();
+	ElemType value = entries[index];
+	while (true) {
+		int first = arity * index + 1;
+		if (first >= n) break;
+		int last = (first + arity < n) ? first + arity : n;
+		int best = first;
+		for (int child = first + 1; child < last; child++) {
+			if (cmpFn(entries[child], entries[best]) > 0) best = child;
 		}
+		if (cmpFn(entries[best], value) <= 0) break;
+		entries[index] = entries[best];
+		index = best;
 	}
-	entries.removeAt(maxIndex);	// remove entry from vector
-	return maxValue;
+	entries[index] = value;
 }
 
 template <typename ElemType>
 int PQueue<ElemType>::bytesUsed() 
 {
-	return sizeof(*this) + entries.bytesUsed();
+	return sizeof(*this) + entries.size() * sizeof(ElemType);
 }
 
 template <typename ElemType>
 string PQueue<ElemType>::implementationName()
 {
-	return "unsorted vector";
+	return IntegerToString(arity) + "-ary heap";
 }
 
 template <typename ElemType>
@@ -244,5 +455,196 @@ void PQueue<ElemType>::printDebuggingInfo()
 }
 
 
+/*
+ * Implementation notes: IndexedPQueue class
+ * -----------------------------------------
+ * The same d-ary heap layout as PQueue, but ordered smallest key
+ * first and holding ids instead of values. The position array lets
+ * decreaseKey find an id's heap slot in O(1) and sift it up from
+ * there. The keys and positions are plain arrays sized to capacity
+ * since they are indexed directly by id.
+ */
+
+template <typename KeyType>
+IndexedPQueue<KeyType>::IndexedPQueue(int capacity, int (cmp)(KeyType, KeyType), int heapArity)
+{
+	if (capacity < 0) Error("Negative capacity given to IndexedPQueue constructor");
+	if (heapArity < 2) Error("IndexedPQueue arity must be at least 2");
+	cmpFn = cmp;
+	arity = heapArity;
+	numIds = capacity;
+	keys = new KeyType[capacity];
+	position = new int[capacity];
+	for (int i = 0; i < capacity; i++) {
+		position[i] = -1;
+	}
+}
+
+template <typename KeyType>
+IndexedPQueue<KeyType>::~IndexedPQueue()
+{
+	delete[] keys;
+	delete[] position;
+}
+
+template <typename KeyType>
+bool IndexedPQueue<KeyType>::isEmpty()
+{
+	return heap.isEmpty();
+}
+
+template <typename KeyType>
+int IndexedPQueue<KeyType>::size()
+{
+	return heap.size();
+}
+
+template <typename KeyType>
+int IndexedPQueue<KeyType>::capacity()
+{
+	return numIds;
+}
+
+template <typename KeyType>
+void IndexedPQueue<KeyType>::checkId(int id, const char *verb)
+{
+	if (id < 0 || id >= numIds)
+		Error("Attempt to " + string(verb) + " id " + IntegerToString(id) +
+			  " in an indexed pqueue of capacity " + IntegerToString(numIds) + ".");
+}
+
+template <typename KeyType>
+bool IndexedPQueue<KeyType>::contains(int id)
+{
+	checkId(id, "look up");
+	return position[id] >= 0;
+}
+
+template <typename KeyType>
+void IndexedPQueue<KeyType>::enqueue(int id, KeyType key)
+{
+	checkId(id, "enqueue");
+	if (position[id] >= 0) Error("Tried to enqueue an id that is already in the pqueue!");
+	keys[id] = key;
+	heap.add(id);
+	position[id] = heap.size() - 1;
+	siftUp(heap.size() - 1);
+}
+
+template <typename KeyType>
+void IndexedPQueue<KeyType>::decreaseKey(int id, KeyType key)
+{
+	checkId(id, "decreaseKey");
+	if (position[id] < 0) Error("Tried to decreaseKey an id that is not in the pqueue!");
+	if (cmpFn(key, keys[id]) > 0) Error("decreaseKey was given a larger key");
+	keys[id] = key;
+	siftUp(position[id]);
+}
+
+template <typename KeyType>
+void IndexedPQueue<KeyType>::changeKey(int id, KeyType key)
+{
+	checkId(id, "changeKey");
+	if (position[id] < 0) Error("Tried to changeKey an id that is not in the pqueue!");
+	bool larger = cmpFn(key, keys[id]) > 0;
+	keys[id] = key;
+	if (larger) {
+		siftDown(position[id]);
+	} else {
+		siftUp(position[id]);
+	}
+}
+
+template <typename KeyType>
+KeyType IndexedPQueue<KeyType>::getKey(int id)
+{
+	checkId(id, "getKey");
+	if (position[id] < 0) Error("Tried to getKey of an id that is not in the pqueue!");
+	return keys[id];
+}
+
+template <typename KeyType>
+int IndexedPQueue<KeyType>::peekMin()
+{
+	if (isEmpty()) Error("Tried to peek at min of an empty pqueue!");
+	return heap[0];
+}
+
+template <typename KeyType>
+int IndexedPQueue<KeyType>::dequeueMin()
+{
+	if (isEmpty()) Error("Tried to dequeue min from an empty pqueue!");
+	int minId = heap[0];
+	int last = heap.size() - 1;
+	position[minId] = -1;
+	if (last > 0) {
+		heap[0] = heap[last];
+		position[heap[0]] = 0;
+	}
+	heap.removeAt(last);
+	if (last > 0) siftDown(0);
+	return minId;
+}
+
+template <typename KeyType>
+void IndexedPQueue<KeyType>::clear()
+{
+	for (int i = 0; i < heap.size(); i++) {
+		position[heap[i]] = -1;
+	}
+	heap.clear();
+}
+
+template <typename KeyType>
+void IndexedPQueue<KeyType>::siftUp(int index)
+{
+	int id = heap[index];
+	KeyType key = keys[id];
+	while (index > 0) {
+		int parent = (index - 1) / arity;
+		if (cmpFn(keys[heap[parent]], key) <= 0) break;
+		heap[index] = heap[parent];
+		position[heap[index]] = index;
+		index = parent;
+	}
+	heap[index] = id;
+	position[id] = index;
+}
+
+template <typename KeyType>
+void IndexedPQueue<KeyType>::siftDown(int index)
+{
+	int n = heap.size();
+	int id = heap[index];
+	KeyType key = keys[id];
+	while (true) {
+		int first = arity * index + 1;
+		if (first >= n) break;
+		int last = (first + arity < n) ? first + arity : n;
+		int best = first;
+		for (int child = first + 1; child < last; child++) {
+			if (cmpFn(keys[heap[child]], keys[heap[best]]) < 0) best = child;
+		}
+		if (cmpFn(keys[heap[best]], key) >= 0) break;
+		heap[index] = heap[best];
+		position[heap[index]] = index;
+		index = best;
+	}
+	heap[index] = id;
+	position[id] = index;
+}
+
+template <typename KeyType>
+int IndexedPQueue<KeyType>::bytesUsed()
+{
+	return sizeof(*this) + heap.size() * sizeof(int) + numIds * (sizeof(KeyType) + sizeof(int));
+}
+
+template <typename KeyType>
+string IndexedPQueue<KeyType>::implementationName()
+{
+	return "indexed " + IntegerToString(arity) + "-ary heap";
+}
+
 
-#endif
\ No newline at end of file
+#endif
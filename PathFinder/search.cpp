@@ -0,0 +1,418 @@
+/*
+ * File: search.cpp
+ * ----------------
+ * Implementation of the searches declared in search.h.
+ */
+
+#include "search.h"
+#include "landmarks.h"
+#include "hierarchy.h"
+#include "pqueue.h"
+#include "strutils.h"
+#include <cmath>
+
+
+const double NoDistance = HUGE_VAL;
+
+
+string SearchAlgorithmName(searchAlgorithmT algorithm)
+{
+	switch (algorithm) {
+	  case DijkstraSearch: return "Dijkstra";
+	  case AStarSearch: return "A*";
+	  case BidirectionalSearch: return "Bidirectional Dijkstra";
+	  case ALTSearch: return "ALT (A* with landmarks)";
+	  case CHSearch: return "Contraction hierarchy";
+	}
+	return "";
+}
+
+searchAlgorithmT StringToSearchAlgorithm(string name)
+{
+	name = ConvertToLowerCase(name);
+	if (name == "dijkstra") return DijkstraSearch;
+	if (name == "astar" || name == "a*") return AStarSearch;
+	if (name == "bidirectional" || name == "bidi") return BidirectionalSearch;
+	if (name == "alt" || name == "landmarks") return ALTSearch;
+	if (name == "ch" || name == "contraction") return CHSearch;
+	Error("Unknown search algorithm \"" + name + "\" (expected dijkstra, astar, bidirectional, alt or ch)");
+	return DijkstraSearch;
+}
+
+
+SearchWorkspace::SearchWorkspace()
+{
+	capacity = 0;
+	for (int i = 0; i < 2; i++) {
+		sides[i].distance = NULL;
+		sides[i].estimate = NULL;
+		sides[i].parent = NULL;
+		sides[i].parentSlot = NULL;
+		sides[i].stamp = NULL;
+		sides[i].generation = 0;
+		sides[i].pq = NULL;
+	}
+}
+
+SearchWorkspace::~SearchWorkspace()
+{
+	freeSides();
+}
+
+void SearchWorkspace::freeSides()
+{
+	for (int i = 0; i < 2; i++) {
+		delete[] sides[i].distance;
+		delete[] sides[i].estimate;
+		delete[] sides[i].parent;
+		delete[] sides[i].parentSlot;
+		delete[] sides[i].stamp;
+		delete sides[i].pq;
+	}
+}
+
+/* Implementation notes: prepare
+ * -----------------------------
+ * The arrays are only reallocated when a search needs more room than
+ * they have, or on the first call, so a workspace used for a series of
+ * queries on one graph allocates once and always has its queues, even
+ * for a graph with no cities. Moving on to the next generation unmarks every city
+ * at once, since no stamp holds the new generation yet. The stamps
+ * are only cleared when the generation counter wraps around to 0,
+ * once every 2^32 searches. The queues may still hold cities from a
+ * search that stopped early, so they are emptied too, which takes
+ * time proportional to what is left in them.
+ */
+void SearchWorkspace::prepare(int numNodes)
+{
+	if (numNodes > capacity || sides[0].pq == NULL) {
+		freeSides();
+		for (int i = 0; i < 2; i++) {
+			sides[i].distance = new double[numNodes];
+			sides[i].estimate = new double[numNodes];
+			sides[i].parent = new int[numNodes];
+			sides[i].parentSlot = new int[numNodes];
+			sides[i].stamp = new unsigned[numNodes];
+			sides[i].pq = new IndexedPQueue<double>(numNodes);
+			for (int v = 0; v < numNodes; v++) {
+				sides[i].stamp[v] = 0;
+			}
+			sides[i].generation = 0;
+		}
+		capacity = numNodes;
+	}
+	for (int i = 0; i < 2; i++) {
+		sides[i].generation++;
+		if (sides[i].generation == 0) {
+			for (int v = 0; v < capacity; v++) {
+				sides[i].stamp[v] = 0;
+			}
+			sides[i].generation = 1;
+		}
+		sides[i].pq->clear();
+	}
+}
+
+
+void ZeroHeuristic::setTarget(int /* target */)
+{
+}
+
+double ZeroHeuristic::estimate(int /* node */)
+{
+	return 0;
+}
+
+EuclideanHeuristic::EuclideanHeuristic(Graph & graph) : graph(graph)
+{
+	scale = graph.getDistanceScale();
+}
+
+EuclideanHeuristic::EuclideanHeuristic(Graph & graph, double scale) : graph(graph)
+{
+	this->scale = scale;
+}
+
+void EuclideanHeuristic::setTarget(int target)
+{
+	goal = graph.getLocation(target);
+}
+
+double EuclideanHeuristic::estimate(int node)
+{
+	coordT where = graph.getLocation(node);
+	double dx = where.x - goal.x;
+	double dy = where.y - goal.y;
+	return scale * sqrt(dx * dx + dy * dy);
+}
+
+CoordinateHeuristic::CoordinateHeuristic(Graph & graph, double (*fn)(coordT from, coordT to)) : graph(graph)
+{
+	this->fn = fn;
+}
+
+void CoordinateHeuristic::setTarget(int target)
+{
+	goal = graph.getLocation(target);
+}
+
+double CoordinateHeuristic::estimate(int node)
+{
+	return fn(graph.getLocation(node), goal);
+}
+
+
+void ShortestPath(Graph & graph, searchAlgorithmT algorithm, int source, int target, searchResultT & result,
+				  Landmarks *landmarks, ContractionHierarchy *hierarchy, SearchWorkspace *workspace)
+{
+	switch (algorithm) {
+	  case DijkstraSearch:
+		DijkstraShortestPath(graph, source, target, result, workspace);
+		break;
+	  case AStarSearch: {
+		EuclideanHeuristic heuristic(graph);
+		AStarShortestPath(graph, source, target, heuristic, result, workspace);
+		break;
+	  }
+	  case BidirectionalSearch:
+		BidirectionalShortestPath(graph, source, target, result, workspace);
+		break;
+	  case ALTSearch: {
+		if (landmarks == NULL) Error("The ALT search needs landmarks for the graph.");
+		LandmarkHeuristic heuristic(*landmarks);
+		AStarShortestPath(graph, source, target, heuristic, result, workspace);
+		break;
+	  }
+	  case CHSearch:
+		if (hierarchy == NULL) Error("The contraction hierarchy search needs a hierarchy for the graph.");
+		hierarchy->query(source, target, result, workspace);
+		break;
+	}
+}
+
+void DijkstraShortestPath(Graph & graph, int source, int target, searchResultT & result,
+						  SearchWorkspace *workspace)
+{
+	ZeroHeuristic none;
+	AStarShortestPath(graph, source, target, none, result, workspace);
+}
+
+
+/* Function: ReconstructPath
+ * -------------------------
+ * Follows the parent links back from the target to the source and
+ * stores the path, source first, in result.nodes.
+ */
+static void ReconstructPath(int source, int target, int parent[], searchResultT & result)
+{
+	result.nodes.clear();
+	for (int node = target; node != source; node = parent[node]) {
+		result.nodes.add(node);
+	}
+	result.nodes.add(source);
+	for (int i = 0, j = result.nodes.size() - 1; i < j; i++, j--) {
+		int temp = result.nodes[i];
+		result.nodes[i] = result.nodes[j];
+		result.nodes[j] = temp;
+	}
+}
+
+/* Implementation notes: AStarShortestPath
+ * ---------------------------------------
+ * The queue is keyed on distance[node] + estimate[node]. Each city's
+ * estimate is computed once, when the search first reaches it, since
+ * it depends only on the city. A city's distance is improved whenever
+ * a shorter way to it is found, whether or not it is still in the
+ * queue; with a consistent heuristic that never happens after the
+ * city has been settled, so each city is expanded at most once and
+ * the search is Dijkstra's algorithm on the reduced arc lengths.
+ */
+void AStarShortestPath(Graph & graph, int source, int target, Heuristic & heuristic, searchResultT & result,
+					   SearchWorkspace *workspace)
+{
+	SearchWorkspace scratch;
+	if (workspace == NULL) workspace = &scratch;
+	workspace->prepare(graph.numNodes());
+	searchSideT & side = workspace->forward();
+	double *distance = side.distance;
+	double *estimate = side.estimate;
+	int *parent = side.parent;
+	IndexedPQueue<double> & pq = *side.pq;
+	heuristic.setTarget(target);
+	distance[source] = 0;
+	estimate[source] = heuristic.estimate(source);
+	parent[source] = source;
+	side.markReached(source);
+	if (estimate[source] != NoDistance) pq.enqueue(source, estimate[source]);	//else the heuristic knows there is no path
+
+	result.found = false;
+	result.distance = 0;
+	result.nodes.clear();
+	result.expanded = 0;
+	while (!pq.isEmpty()) {
+		int city = pq.dequeueMin();
+		result.expanded++;
+		if (city == target) {
+			result.found = true;
+			result.distance = distance[target];
+			ReconstructPath(source, target, parent, result);
+			break;
+		}
+		for (int slot = graph.firstSlot(city); slot < graph.endSlot(city); slot++) {
+			int neighbor = graph.targetAt(slot);
+			double newDistance = distance[city] + graph.weightAt(slot);
+			if (!side.isReached(neighbor)) {
+				estimate[neighbor] = heuristic.estimate(neighbor);
+				side.markReached(neighbor);
+			} else if (newDistance >= distance[neighbor]) {
+				continue;
+			}
+			distance[neighbor] = newDistance;
+			parent[neighbor] = city;
+			if (pq.contains(neighbor)) {
+				pq.decreaseKey(neighbor, newDistance + estimate[neighbor]);
+			} else {
+				pq.enqueue(neighbor, newDistance + estimate[neighbor]);
+			}
+		}
+	}
+}
+
+
+/* Function: ExpandSide
+ * --------------------
+ * Settles the next city of one side and relaxes its arcs. Every time
+ * a city's distance on this side improves and the other side has
+ * reached it too, the path through that city is a candidate for the
+ * shortest one, and best and meeting are updated if it is shorter.
+ */
+static void ExpandSide(Graph & graph, searchSideT & side, searchSideT & other, double & best, int & meeting)
+{
+	int city = side.pq->dequeueMin();
+	for (int slot = graph.firstSlot(city); slot < graph.endSlot(city); slot++) {
+		int neighbor = graph.targetAt(slot);
+		double newDistance = side.distance[city] + graph.weightAt(slot);
+		if (side.isReached(neighbor) && newDistance >= side.distance[neighbor]) continue;
+		side.distance[neighbor] = newDistance;
+		side.parent[neighbor] = city;
+		side.markReached(neighbor);
+		if (side.pq->contains(neighbor)) {
+			side.pq->decreaseKey(neighbor, newDistance);
+		} else {
+			side.pq->enqueue(neighbor, newDistance);
+		}
+		if (other.isReached(neighbor) && (meeting == -1 || newDistance + other.distance[neighbor] < best)) {
+			best = newDistance + other.distance[neighbor];
+			meeting = neighbor;
+		}
+	}
+}
+
+/* Implementation notes: BidirectionalShortestPath
+ * -----------------------------------------------
+ * Stopping as soon as some city has been settled by both sides is
+ * not enough: the shortest path may run through an arc between a
+ * city settled forwards and one settled backwards instead. The search
+ * stops once the smallest keys of the two queues add up to at least
+ * the best path found, since any path not yet seen would have to
+ * leave both settled regions and so be at least that long. Arcs are
+ * undirected, so the backward side uses the same adjacency.
+ */
+void BidirectionalShortestPath(Graph & graph, int source, int target, searchResultT & result,
+							   SearchWorkspace *workspace)
+{
+	result.found = false;
+	result.distance = 0;
+	result.nodes.clear();
+	result.expanded = 0;
+	if (source == target) {
+		result.found = true;
+		result.nodes.add(source);
+		return;
+	}
+
+	SearchWorkspace scratch;
+	if (workspace == NULL) workspace = &scratch;
+	workspace->prepare(graph.numNodes());
+	searchSideT & forward = workspace->forward();
+	searchSideT & backward = workspace->backward();
+	forward.distance[source] = 0;
+	forward.parent[source] = source;
+	forward.markReached(source);
+	forward.pq->enqueue(source, 0);
+	backward.distance[target] = 0;
+	backward.parent[target] = target;
+	backward.markReached(target);
+	backward.pq->enqueue(target, 0);
+
+	double best = 0;
+	int meeting = -1;					//city on the best path found so far
+	while (!forward.pq->isEmpty() && !backward.pq->isEmpty()) {
+		double forwardKey = forward.pq->getKey(forward.pq->peekMin());
+		double backwardKey = backward.pq->getKey(backward.pq->peekMin());
+		if (meeting != -1 && forwardKey + backwardKey >= best) break;
+		if (forwardKey <= backwardKey) {
+			ExpandSide(graph, forward, backward, best, meeting);
+		} else {
+			ExpandSide(graph, backward, forward, best, meeting);
+		}
+		result.expanded++;
+	}
+
+	if (meeting != -1) {
+		result.found = true;
+		result.distance = best;
+		for (int city = meeting; city != source; city = forward.parent[city]) {
+			result.nodes.add(city);
+		}
+		result.nodes.add(source);
+		for (int i = 0, j = result.nodes.size() - 1; i < j; i++, j--) {
+			int temp = result.nodes[i];
+			result.nodes[i] = result.nodes[j];
+			result.nodes[j] = temp;
+		}
+		for (int city = meeting; city != target; ) {
+			city = backward.parent[city];
+			result.nodes.add(city);
+		}
+	}
+}
+
+
+/* Implementation notes: ShortestPathTree
+ * --------------------------------------
+ * Plain Dijkstra with nothing to stop for. Arc lengths are never
+ * negative, so a settled city is never improved; an improvement is
+ * either a city reached for the first time, which is enqueued, or one
+ * still in the queue, whose key is decreased.
+ */
+void ShortestPathTree(Graph & graph, int source, double distance[], int parent[], SearchWorkspace *workspace)
+{
+	int numCities = graph.numNodes();
+	for (int i = 0; i < numCities; i++) {
+		distance[i] = NoDistance;
+		if (parent != NULL) parent[i] = -1;
+	}
+	SearchWorkspace scratch;
+	if (workspace == NULL) workspace = &scratch;
+	workspace->prepare(numCities);
+	IndexedPQueue<double> & pq = *workspace->forward().pq;
+	distance[source] = 0;
+	if (parent != NULL) parent[source] = source;
+	pq.enqueue(source, 0);
+	while (!pq.isEmpty()) {
+		int city = pq.dequeueMin();
+		for (int slot = graph.firstSlot(city); slot < graph.endSlot(city); slot++) {
+			int neighbor = graph.targetAt(slot);
+			double newDistance = distance[city] + graph.weightAt(slot);
+			if (newDistance >= distance[neighbor]) continue;
+			if (distance[neighbor] == NoDistance) {
+				pq.enqueue(neighbor, newDistance);
+			} else {
+				pq.decreaseKey(neighbor, newDistance);
+			}
+			distance[neighbor] = newDistance;
+			if (parent != NULL) parent[neighbor] = city;
+		}
+	}
+}
@@ -0,0 +1,291 @@
+/*
+ * File: search.h
+ * --------------
+ * Point-to-point shortest path searches over the Graph class:
+ * Dijkstra's algorithm; A*, which uses the locations of the cities
+ * to head towards the target instead of spreading out evenly in every
+ * direction; and bidirectional Dijkstra, which grows one search from
+ * each end until they meet. The searches that need precomputed data
+ * (landmarks.h, hierarchy.h) are run through ShortestPath as well.
+ */
+
+#ifndef _search_h
+#define _search_h
+
+#include "genlib.h"
+#include "vector.h"
+#include "disallowcopy.h"
+#include "pqueue.h"
+#include "graph.h"
+
+
+/*
+ * Type: searchAlgorithmT
+ * ----------------------
+ * Names the available point-to-point search algorithms.
+ */
+enum searchAlgorithmT {
+	DijkstraSearch,			// settle cities in order of their distance from the source
+	AStarSearch,			// settle cities in order of distance plus straight-line distance to the target
+	BidirectionalSearch,	// Dijkstra from the source and from the target at once, until they meet
+	ALTSearch,				// A* with lower bounds from precomputed landmark distances
+	CHSearch				// upward searches from both ends in a precomputed contraction hierarchy
+};
+
+const int NumSearchAlgorithms = 5;
+
+
+/*
+ * Constant: NoDistance
+ * --------------------
+ * The distance to a city that cannot be reached.
+ */
+extern const double NoDistance;
+
+class Landmarks;			// see landmarks.h
+class ContractionHierarchy;	// see hierarchy.h
+
+
+/*
+ * Type: searchResultT
+ * -------------------
+ * What a search found. If the target cannot be reached, found is
+ * false and nodes is empty. expanded counts the cities the search
+ * took off its queue, which is the usual measure of how much work
+ * a search did.
+ */
+struct searchResultT {
+	bool found;
+	double distance;
+	Vector<int> nodes;		// the path, source first and target last
+	int expanded;
+};
+
+
+/*
+ * Type: searchSideT
+ * -----------------
+ * The arrays one direction of a search works in, indexed by city id.
+ * A search from one end only uses the forward side. A city has been
+ * reached by the current search exactly when its stamp equals the
+ * side's generation; the other arrays only hold meaningful values for
+ * cities that have been reached, so they never need to be cleared.
+ */
+struct searchSideT {
+	double *distance;		// best distance found so far
+	double *estimate;		// A*'s estimate of the distance left
+	int *parent;			// city each city was reached from
+	int *parentSlot;		// the edge each city was reached by, for searches that need it
+	unsigned *stamp;		// generation of the last search that reached each city
+	unsigned generation;
+	IndexedPQueue<double> *pq;
+
+	bool isReached(int city) { return stamp[city] == generation; }
+	void markReached(int city) { stamp[city] = generation; }
+};
+
+/*
+ * Class: SearchWorkspace
+ * ----------------------
+ * The scratch memory of the searches: a forward and a backward side,
+ * each with one entry per city. The searches below take an optional
+ * workspace and allocate a temporary one when they are not given
+ * one, which costs several arrays as long as the graph on every
+ * query. A caller running many queries keeps a workspace and passes
+ * it to each of them instead: after the first query, starting a new
+ * one allocates nothing and takes time independent of the size of
+ * the graph. A workspace must only be used by one
+ * search at a time, so a program running searches on several
+ * threads gives each thread its own.
+ */
+class SearchWorkspace {
+  public:
+	SearchWorkspace();
+	~SearchWorkspace();
+
+	/*
+	 * Member function: prepare
+	 * Usage: workspace.prepare(graph.numNodes());
+	 * -------------------------------------------
+	 * Makes room for a graph of numNodes cities, if there is not
+	 * room already, and marks every city as not reached on both
+	 * sides with both queues empty. Each search calls this before
+	 * it starts. Unless the arrays have to grow, this takes time
+	 * proportional to the number of cities left in the queues by the
+	 * last search, not to the size of the graph.
+	 */
+	void prepare(int numNodes);
+
+	searchSideT & forward();
+	searchSideT & backward();
+
+  private:
+	DISALLOW_COPYING(SearchWorkspace)
+
+	int capacity;			// the number of cities the arrays have room for
+	searchSideT sides[2];
+
+	void freeSides();
+};
+
+
+/*
+ * Class: Heuristic
+ * ----------------
+ * An estimate of the distance left to the target, which A* adds to
+ * the distance so far to decide which city to settle next. The search
+ * calls setTarget once and then estimate for each city it reaches.
+ *
+ * To guarantee shortest paths the estimate must never be more than
+ * the true distance (it must be admissible). If it is also consistent,
+ * meaning it drops by no more than the length of any arc followed,
+ * no city is settled twice. An estimate of NoDistance says the
+ * target cannot be reached at all. A heuristic of your own is a
+ * subclass defining these two member functions.
+ */
+class Heuristic {
+  public:
+	virtual ~Heuristic() {}
+	virtual void setTarget(int target) = 0;
+	virtual double estimate(int node) = 0;
+};
+
+/*
+ * Class: ZeroHeuristic
+ * --------------------
+ * Estimates 0 everywhere, which makes A* behave exactly like
+ * Dijkstra's algorithm.
+ */
+class ZeroHeuristic : public Heuristic {
+  public:
+	void setTarget(int target);
+	double estimate(int node);
+};
+
+/*
+ * Class: EuclideanHeuristic
+ * -------------------------
+ * Estimates the straight-line distance between the locations of the
+ * city and the target, multiplied by scale to turn screen units into
+ * the units of the arc lengths. The default scale is the graph's
+ * getDistanceScale(), the largest that keeps the estimate consistent.
+ * A larger scale makes A* expand fewer cities but may cost it the
+ * shortest path.
+ */
+class EuclideanHeuristic : public Heuristic {
+  public:
+	EuclideanHeuristic(Graph & graph);
+	EuclideanHeuristic(Graph & graph, double scale);
+	void setTarget(int target);
+	double estimate(int node);
+
+  private:
+	Graph & graph;
+	double scale;
+	coordT goal;
+};
+
+/*
+ * Class: CoordinateHeuristic
+ * --------------------------
+ * Adapts a plain function of two locations, such as a Manhattan or
+ * great-circle distance, into a Heuristic, calling
+ * fn(location of the city, location of the target).
+ */
+class CoordinateHeuristic : public Heuristic {
+  public:
+	CoordinateHeuristic(Graph & graph, double (*fn)(coordT from, coordT to));
+	void setTarget(int target);
+	double estimate(int node);
+
+  private:
+	Graph & graph;
+	double (*fn)(coordT from, coordT to);
+	coordT goal;
+};
+
+
+/*
+ * Function: ShortestPath
+ * Usage: ShortestPath(graph, AStarSearch, source, target, result);
+ * ----------------------------------------------------------------
+ * Finds a shortest path from source to target with the given
+ * algorithm and stores it in result. A* uses a EuclideanHeuristic
+ * with the graph's own scale. ALT needs landmarks built for the
+ * graph, and the contraction hierarchy search a hierarchy built for
+ * it; each raises an error if it is not given them. The search runs
+ * in the workspace if one is given.
+ */
+void ShortestPath(Graph & graph, searchAlgorithmT algorithm, int source, int target, searchResultT & result,
+				  Landmarks *landmarks = NULL, ContractionHierarchy *hierarchy = NULL,
+				  SearchWorkspace *workspace = NULL);
+
+/*
+ * Functions: DijkstraShortestPath, AStarShortestPath
+ * Usage: AStarShortestPath(graph, source, target, heuristic, result);
+ * -------------------------------------------------------------------
+ * The individual searches behind ShortestPath. AStarShortestPath
+ * takes any heuristic. If the heuristic is admissible but not
+ * consistent, a city whose distance improves after it was settled is
+ * put back on the queue, so the path found is still a shortest one.
+ */
+void DijkstraShortestPath(Graph & graph, int source, int target, searchResultT & result,
+						  SearchWorkspace *workspace = NULL);
+void AStarShortestPath(Graph & graph, int source, int target, Heuristic & heuristic, searchResultT & result,
+					   SearchWorkspace *workspace = NULL);
+
+/*
+ * Function: BidirectionalShortestPath
+ * Usage: BidirectionalShortestPath(graph, source, target, result);
+ * ----------------------------------------------------------------
+ * Runs Dijkstra's algorithm forwards from the source and backwards
+ * from the target, always advancing the side whose next city is
+ * closer to its end. On a road network each side only has to cover
+ * a disc about half as wide as a one-sided search would, which
+ * settles about half as many cities.
+ */
+void BidirectionalShortestPath(Graph & graph, int source, int target, searchResultT & result,
+							   SearchWorkspace *workspace = NULL);
+
+/*
+ * Function: ShortestPathTree
+ * Usage: ShortestPathTree(graph, source, distance, parent);
+ * ---------------------------------------------------------
+ * Runs Dijkstra's algorithm from the source to every city. Fills
+ * distance (numNodes() entries) with the length of the shortest path
+ * to each city, or NoDistance if it cannot be reached, and, unless
+ * parent is NULL, parent with the city before it on that path (the
+ * source is its own parent, and unreachable cities have -1). Only the
+ * queue is taken from the workspace, if one is given.
+ */
+void ShortestPathTree(Graph & graph, int source, double distance[], int parent[] = NULL,
+					  SearchWorkspace *workspace = NULL);
+
+/*
+ * Function: SearchAlgorithmName
+ * Usage: cout << SearchAlgorithmName(algorithm);
+ * ----------------------------------------------
+ * Returns the display name of an algorithm, e.g. "A*".
+ */
+string SearchAlgorithmName(searchAlgorithmT algorithm);
+
+/*
+ * Function: StringToSearchAlgorithm
+ * Usage: algorithm = StringToSearchAlgorithm(GetOption("search", "dijkstra"));
+ * ----------------------------------------------------------------------------
+ * Converts a name given on the command line ("dijkstra", "astar",
+ * "bidirectional", "alt" or "ch") to an algorithm. Raises an error if the name is not recognized.
+ */
+searchAlgorithmT StringToSearchAlgorithm(string name);
+
+inline searchSideT & SearchWorkspace::forward()
+{
+	return sides[0];
+}
+
+inline searchSideT & SearchWorkspace::backward()
+{
+	return sides[1];
+}
+
+#endif
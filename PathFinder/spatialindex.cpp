@@ -0,0 +1,225 @@
+/*
+ * File: spatialindex.cpp
+ * ----------------------
+ * Implementation of the SpatialIndex class declared in spatialindex.h.
+ */
+
+#include "spatialindex.h"
+#include <cmath>
+#include <cstdlib> // for NULL
+
+
+/* The number of nodes a cell is sized to hold on average. */
+static const int NodesPerCell = 2;
+
+
+SpatialIndex::SpatialIndex()
+{
+	count = 0;
+	columns = rows = 0;
+	minX = minY = 0;
+	cellSize = 1;
+	cellStart = NULL;
+	ids = NULL;
+	points = NULL;
+}
+
+SpatialIndex::~SpatialIndex()
+{
+	clear();
+}
+
+void SpatialIndex::clear()
+{
+	delete[] cellStart;
+	delete[] ids;
+	delete[] points;
+	cellStart = NULL;
+	ids = NULL;
+	points = NULL;
+	count = 0;
+	columns = rows = 0;
+}
+
+/* Implementation notes: build
+ * ---------------------------
+ * The cell size is chosen so that the bounding box holds about
+ * count / NodesPerCell square cells. The cells are never smaller than
+ * the longer side of the box divided by that number, so a box that is
+ * very thin, or has no area at all because the nodes lie on a line,
+ * gets one or two rows of cells along its length rather than a grid
+ * that is far too fine. Either way there are O(count) cells. The
+ * entries are then grouped by cell with a counting sort, the same way
+ * Graph::build lays out its adjacency arrays.
+ */
+void SpatialIndex::build(Graph & graph)
+{
+	clear();
+	count = graph.numNodes();
+	if (count == 0) return;
+
+	double maxX, maxY;
+	minX = maxX = graph.getLocation(0).x;
+	minY = maxY = graph.getLocation(0).y;
+	for (int i = 1; i < count; i++) {
+		coordT where = graph.getLocation(i);
+		if (where.x < minX) minX = where.x;
+		if (where.x > maxX) maxX = where.x;
+		if (where.y < minY) minY = where.y;
+		if (where.y > maxY) maxY = where.y;
+	}
+	double width = maxX - minX;
+	double height = maxY - minY;
+	double cells = double(count) / NodesPerCell;
+	if (cells < 1) cells = 1;
+	double longer = (width > height) ? width : height;
+	if (longer > 0) {
+		cellSize = sqrt(width * height / cells);
+		if (cellSize < longer / cells) cellSize = longer / cells;
+	} else {
+		cellSize = 1;
+	}
+	columns = int(width / cellSize) + 1;
+	rows = int(height / cellSize) + 1;
+
+	int numCells = columns * rows;
+	cellStart = new int[numCells + 1];
+	int *cellOf = new int[count];
+	for (int c = 0; c <= numCells; c++) {
+		cellStart[c] = 0;
+	}
+	for (int i = 0; i < count; i++) {
+		coordT where = graph.getLocation(i);
+		cellOf[i] = rowOf(where.y) * columns + columnOf(where.x);
+		cellStart[cellOf[i] + 1]++;
+	}
+	for (int c = 0; c < numCells; c++) {
+		cellStart[c + 1] += cellStart[c];
+	}
+	int *next = new int[numCells];
+	for (int c = 0; c < numCells; c++) {
+		next[c] = cellStart[c];
+	}
+	ids = new int[count];
+	points = new coordT[count];
+	for (int i = 0; i < count; i++) {
+		int entry = next[cellOf[i]]++;
+		ids[entry] = i;
+		points[entry] = graph.getLocation(i);
+	}
+	delete[] next;
+	delete[] cellOf;
+}
+
+/* Private member functions: columnOf, rowOf
+ * -----------------------------------------
+ * Return the column (row) of the cell a coordinate falls in, clamped
+ * to the grid so that points outside it map to the nearest edge cell.
+ */
+int SpatialIndex::columnOf(double x)
+{
+	double column = floor((x - minX) / cellSize);
+	if (column < 0) return 0;
+	if (column >= columns) return columns - 1;
+	return int(column);
+}
+
+int SpatialIndex::rowOf(double y)
+{
+	double row = floor((y - minY) / cellSize);
+	if (row < 0) return 0;
+	if (row >= rows) return rows - 1;
+	return int(row);
+}
+
+/* Private member function: searchCell
+ * -----------------------------------
+ * Checks every entry of one cell against the best match so far and
+ * returns the (possibly new) best id. Cells off the grid are empty.
+ * Distances are compared squared to avoid the square root.
+ */
+int SpatialIndex::searchCell(int column, int row, coordT where, int best, double & bestSquared)
+{
+	if (column < 0 || column >= columns || row < 0 || row >= rows) return best;
+	int cell = row * columns + column;
+	for (int e = cellStart[cell]; e < cellStart[cell + 1]; e++) {
+		double dx = points[e].x - where.x;
+		double dy = points[e].y - where.y;
+		double squared = dx * dx + dy * dy;
+		if (squared < bestSquared || (squared == bestSquared && (best == -1 || ids[e] < best))) {
+			best = ids[e];
+			bestSquared = squared;
+		}
+	}
+	return best;
+}
+
+/* Private member function: searchNearest
+ * --------------------------------------
+ * The search starts in the cell of the point and works outwards in
+ * square rings of cells. Every cell in ring r is at least r - 1 whole
+ * cells away from the point (this holds for points off the grid as
+ * well, since they are clamped to the edge cell nearest to them), so
+ * once that is farther than the best distance found, or than
+ * maxDistance if nothing has been found, the search can stop. Only
+ * the part of each ring that lies on the grid is visited, so a grid
+ * of one or two rows costs a few cells per ring.
+ */
+int SpatialIndex::searchNearest(coordT where, double maxDistance)
+{
+	if (count == 0) return -1;
+	int column = columnOf(where.x);
+	int row = rowOf(where.y);
+	int maxRing = (columns > rows ? columns : rows);
+	int best = -1;
+	double bestSquared = maxDistance * maxDistance;
+	best = searchCell(column, row, where, best, bestSquared);
+	for (int r = 1; r <= maxRing; r++) {
+		double bound = (r - 1) * cellSize;
+		if (bound * bound > bestSquared) break;
+		int firstColumn = (column - r < 0) ? 0 : column - r;
+		int lastColumn = (column + r >= columns) ? columns - 1 : column + r;
+		for (int c = firstColumn; c <= lastColumn; c++) {
+			best = searchCell(c, row - r, where, best, bestSquared);
+			best = searchCell(c, row + r, where, best, bestSquared);
+		}
+		int firstRow = (row - r + 1 < 0) ? 0 : row - r + 1;
+		int lastRow = (row + r - 1 >= rows) ? rows - 1 : row + r - 1;
+		for (int w = firstRow; w <= lastRow; w++) {
+			best = searchCell(column - r, w, where, best, bestSquared);
+			best = searchCell(column + r, w, where, best, bestSquared);
+		}
+	}
+	return best;
+}
+
+int SpatialIndex::nearest(coordT where)
+{
+	return searchNearest(where, HUGE_VAL);
+}
+
+int SpatialIndex::nearestWithin(coordT where, double maxDistance)
+{
+	if (maxDistance < 0) return -1;
+	return searchNearest(where, maxDistance);
+}
+
+int SpatialIndex::findWithin(coordT where, double radius, Vector<int> & result)
+{
+	result.clear();
+	if (count == 0 || radius < 0) return 0;
+	double squaredRadius = radius * radius;
+	int firstColumn = columnOf(where.x - radius), lastColumn = columnOf(where.x + radius);
+	int firstRow = rowOf(where.y - radius), lastRow = rowOf(where.y + radius);
+	for (int row = firstRow; row <= lastRow; row++) {
+		for (int column = firstColumn; column <= lastColumn; column++) {
+			int cell = row * columns + column;
+			for (int e = cellStart[cell]; e < cellStart[cell + 1]; e++) {
+				double dx = points[e].x - where.x;
+				double dy = points[e].y - where.y;
+				if (dx * dx + dy * dy <= squaredRadius) result.add(ids[e]);
+			}
+		}
+	}
+	return result.size();
+}
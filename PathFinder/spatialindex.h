@@ -0,0 +1,107 @@
+/*
+ * File: spatialindex.h
+ * --------------------
+ * A uniform grid over the locations of the nodes of a graph, which
+ * answers "which node is nearest to this point" and "which nodes are
+ * within this distance of this point" by looking only at the grid
+ * cells around the point instead of at every node.
+ */
+
+#ifndef _spatialindex_h
+#define _spatialindex_h
+
+#include "genlib.h"
+#include "vector.h"
+#include "disallowcopy.h"
+#include "graph.h"
+
+
+/*
+ * Class: SpatialIndex
+ * -------------------
+ * The bounding box of the nodes is cut into square cells holding two
+ * nodes each on average, and the nodes of each cell are stored next
+ * to each other. Building the index takes O(V); a query takes time
+ * proportional to the number of nodes in the cells it has to look at,
+ * which is a handful for nodes that are spread out.
+ */
+class SpatialIndex {
+  public:
+
+	SpatialIndex();
+	~SpatialIndex();
+
+	/*
+	 * Member function: build
+	 * Usage: index.build(graph);
+	 * --------------------------
+	 * Indexes the locations of all the nodes in the graph, replacing
+	 * whatever was indexed before. The graph must have been built. The
+	 * index keeps its own copy of the locations, so it has to be
+	 * rebuilt if another graph is loaded but not otherwise.
+	 */
+	void build(Graph & graph);
+
+	/*
+	 * Member function: clear
+	 * Usage: index.clear();
+	 * ---------------------
+	 * Empties the index.
+	 */
+	void clear();
+
+	/*
+	 * Member function: nearest
+	 * Usage: int id = index.nearest(where);
+	 * -------------------------------------
+	 * Returns the id of the node nearest to the given point, which may
+	 * lie outside the area covered by the graph, or -1 if the index is
+	 * empty. Ties go to the lower id.
+	 */
+	int nearest(coordT where);
+
+	/*
+	 * Member function: nearestWithin
+	 * Usage: int id = index.nearestWithin(click, radius);
+	 * ---------------------------------------------------
+	 * Returns the id of the node nearest to the given point if it is
+	 * no farther away than maxDistance, or -1 otherwise.
+	 */
+	int nearestWithin(coordT where, double maxDistance);
+
+	/*
+	 * Member function: findWithin
+	 * Usage: int n = index.findWithin(where, radius, ids);
+	 * ----------------------------------------------------
+	 * Replaces the contents of ids with the ids of every node no
+	 * farther than radius from the given point, in no particular
+	 * order, and returns how many there are.
+	 */
+	int findWithin(coordT where, double radius, Vector<int> & ids);
+
+	int size();
+
+  private:
+	DISALLOW_COPYING(SpatialIndex)
+
+	int count;
+	int columns, rows;
+	double minX, minY;
+	double cellSize;
+	int *cellStart;		// columns*rows+1 entries; cell c holds entries [cellStart[c], cellStart[c+1])
+	int *ids;			// node id of each entry, grouped by cell
+	coordT *points;		// location of each entry, next to the others in its cell
+
+	int columnOf(double x);
+	int rowOf(double y);
+	int searchCell(int column, int row, coordT where, int best, double & bestSquared);
+	int searchNearest(coordT where, double maxDistance);
+};
+
+
+inline int SpatialIndex::size()
+{
+	return count;
+}
+
+#endif
@@ -0,0 +1,23 @@
+/*
+ * File: timer.cpp
+ * ---------------
+ * Implementation of the timing helpers declared in timer.h.
+ */
+
+#include "timer.h"
+#include <sys/time.h>
+#include <cstdlib> // for NULL
+
+
+double CurrentTime()
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return now.tv_sec + now.tv_usec / 1000000.0;
+}
+
+double MegabytesPerSecond(double numBytes, double seconds)
+{
+	if (seconds < 0.000001) seconds = 0.000001;
+	return numBytes / (1024.0 * 1024.0) / seconds;
+}
@@ -0,0 +1,29 @@
+/*
+ * File: timer.h
+ * -------------
+ * Wall-clock timing for the progress and throughput reports.
+ */
+
+#ifndef _timer_h
+#define _timer_h
+
+
+/*
+ * Function: CurrentTime
+ * Usage: double start = CurrentTime();
+ * ------------------------------------
+ * Returns the current wall-clock time in seconds, with microsecond
+ * resolution. Only differences between two calls are meaningful.
+ */
+double CurrentTime();
+
+/*
+ * Function: MegabytesPerSecond
+ * Usage: rate = MegabytesPerSecond(numBytes, seconds);
+ * ----------------------------------------------------
+ * Returns the throughput of handling numBytes in the given time,
+ * guarding against a zero elapsed time on very small inputs.
+ */
+double MegabytesPerSecond(double numBytes, double seconds);
+
+#endif
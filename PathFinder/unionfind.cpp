@@ -0,0 +1,94 @@
+/*
+ * File: unionfind.cpp
+ * -------------------
+ * Implementation of the UnionFind class declared in unionfind.h.
+ */
+
+#include "unionfind.h"
+#include "strutils.h"
+
+
+UnionFind::UnionFind(int size)
+{
+	if (size < 0) Error("Negative size given to UnionFind constructor");
+	numIds = size;
+	setCount = size;
+	parent = new int[size];
+	rank = new unsigned char[size];
+	for (int i = 0; i < size; i++) {
+		parent[i] = i;
+		rank[i] = 0;
+	}
+}
+
+UnionFind::~UnionFind()
+{
+	delete[] parent;
+	delete[] rank;
+}
+
+void UnionFind::checkId(int id)
+{
+	if (id < 0 || id >= numIds)
+		Error("Id " + IntegerToString(id) + " is not in a UnionFind of size " + IntegerToString(numIds) + ".");
+}
+
+/* Implementation notes: find
+ * --------------------------
+ * The first loop walks up to the root. The second walks the same path
+ * again and points every node on it straight at the root, so the next
+ * find on any of them takes one step. Both loops are iterative so a
+ * long chain cannot overflow the stack.
+ */
+int UnionFind::find(int id)
+{
+	checkId(id);
+	int root = id;
+	while (parent[root] != root) {
+		root = parent[root];
+	}
+	while (parent[id] != root) {
+		int next = parent[id];
+		parent[id] = root;
+		id = next;
+	}
+	return root;
+}
+
+/* Implementation notes: merge
+ * ---------------------------
+ * The root with the smaller rank is hung under the other root. Only
+ * when both ranks are equal does the height grow, which keeps every
+ * tree's height (and so every rank) below log2(size).
+ */
+bool UnionFind::merge(int a, int b)
+{
+	int rootA = find(a);
+	int rootB = find(b);
+	if (rootA == rootB) return false;
+	if (rank[rootA] < rank[rootB]) {
+		parent[rootA] = rootB;
+	} else if (rank[rootA] > rank[rootB]) {
+		parent[rootB] = rootA;
+	} else {
+		parent[rootB] = rootA;
+		rank[rootA]++;
+	}
+	setCount--;
+	return true;
+}
+
+bool UnionFind::connected(int a, int b)
+{
+	return find(a) == find(b);
+}
+
+int UnionFind::numSets()
+{
+	return setCount;
+}
+
+int UnionFind::size()
+{
+	return numIds;
+}
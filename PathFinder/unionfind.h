@@ -0,0 +1,84 @@
+/*
+ * File: unionfind.h
+ * -----------------
+ * Defines the UnionFind class, a disjoint-set forest over the
+ * integer node ids of a graph.
+ */
+
+#ifndef _unionfind_h
+#define _unionfind_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+
+
+/*
+ * Class: UnionFind
+ * ----------------
+ * Keeps track of a partition of the ids 0..size-1 into disjoint sets.
+ * Each set is a tree whose root is the set's representative. Trees are
+ * joined by rank (the shorter tree goes under the taller one) and find
+ * compresses every path it walks, so any sequence of m operations runs
+ * in O(m a(n)), where a is the inverse Ackermann function (at most 4
+ * for any graph that fits in memory).
+ */
+class UnionFind {
+  public:
+
+	/*
+	 * Constructor: UnionFind
+	 * Usage: UnionFind components(graph.numNodes());
+	 * ----------------------------------------------
+	 * Puts each of the ids 0..size-1 in a set of its own.
+	 */
+	explicit UnionFind(int size);
+	~UnionFind();
+
+	/*
+	 * Member function: find
+	 * Usage: root = components.find(id);
+	 * ----------------------------------
+	 * Returns the representative of the set containing id. Two ids
+	 * are in the same set exactly when find returns the same value.
+	 */
+	int find(int id);
+
+	/*
+	 * Member function: merge
+	 * Usage: if (components.merge(a, b)) . . .
+	 * ----------------------------------------
+	 * Joins the sets containing a and b. Returns true if they were
+	 * separate sets, false if they were already the same set.
+	 */
+	bool merge(int a, int b);
+
+	/*
+	 * Member function: connected
+	 * Usage: if (components.connected(a, b)) . . .
+	 * --------------------------------------------
+	 * Returns true if a and b are in the same set.
+	 */
+	bool connected(int a, int b);
+
+	/*
+	 * Member function: numSets
+	 * Usage: n = components.numSets();
+	 * --------------------------------
+	 * Returns the number of disjoint sets remaining.
+	 */
+	int numSets();
+
+	int size();
+
+  private:
+	DISALLOW_COPYING(UnionFind)
+
+	int numIds;
+	int setCount;
+	int *parent;		// parent[id] == id for a root
+	unsigned char *rank;	// upper bound on the height of the tree at a root
+
+	void checkId(int id);
+};
+
+#endif